@@ -0,0 +1,158 @@
+// bench_parse.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+// Measures the time and memory needed to load CNF problems into the
+// arena-backed cnf_expr, alongside the hash-map representation it replaced,
+// and the throughput of the memory-mapped, parallel and stream parse paths.
+// Usage: bench_parse PROBLEM_FILE...
+
+#include "cnf.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+    // total bytes currently held by counting_allocator
+    std::size_t allocated_bytes = 0;
+
+    // an allocator that records the bytes it hands out
+    template <typename T>
+    struct counting_allocator {
+        using value_type = T;
+        counting_allocator() = default;
+        template <typename U>
+        counting_allocator(const counting_allocator<U>&) {}
+        T* allocate(std::size_t n) {
+            allocated_bytes += n * sizeof(T);
+            return std::allocator<T>().allocate(n);
+        }
+        void deallocate(T* p, std::size_t n) {
+            allocated_bytes -= n * sizeof(T);
+            std::allocator<T>().deallocate(p, n);
+        }
+        template <typename U>
+        bool operator==(const counting_allocator<U>&) const { return true; }
+    };
+
+    template <typename T>
+    using counted_set = std::unordered_set<T, std::hash<T>, std::equal_to<T>, counting_allocator<T>>;
+    template <typename K, typename V>
+    using counted_map = std::unordered_map<
+        K, V, std::hash<K>, std::equal_to<K>, counting_allocator<std::pair<const K, V>>
+    >;
+
+    // the previous cnf_expr layout: mirrored hash maps of hash sets
+    struct legacy_expr {
+        counted_map<int, counted_set<int>> literals;
+        counted_map<int, counted_set<int>> clauses;
+
+        void add_literal(int lit, int cl) {
+            if (!literals.contains(std::abs(lit))) {
+                literals.insert({std::abs(lit), counted_set<int>()});
+                literals.insert({-std::abs(lit), counted_set<int>()});
+            }
+            literals[lit].insert(cl);
+            if (!clauses.contains(cl)) {
+                clauses.insert({cl, counted_set<int>()});
+            }
+            clauses[cl].insert(lit);
+        }
+    };
+
+    // load a CNF body the way the previous parser did
+    void legacy_parse(std::istream& istr, legacy_expr& expr) {
+        std::string line;
+        while (std::getline(istr, line).good()) {
+            if (line.size() != 0 && line.at(0) != 'c') break;
+        }
+        int lit;
+        int cl(1);
+        do {
+            if (istr.peek() == 'c') {
+                istr.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                continue;
+            }
+            if (istr >> lit) {
+                if (lit == 0) {
+                    cl++;
+                } else {
+                    expr.add_literal(lit, cl);
+                }
+            }
+        } while (istr.good());
+    }
+
+}
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+    if (argc < 2) {
+        std::cerr << "Usage: bench_parse PROBLEM_FILE..." << std::endl;
+        return 2;
+    }
+    for (int i(1); i < argc; i++) try {
+        std::ifstream file(argv[i]);
+        if (!file) {
+            throw std::invalid_argument(err::not_open_file);
+        }
+        std::stringstream contents;
+        contents << file.rdbuf();
+        const std::string text = contents.str();
+
+        // memory-mapped parse
+        auto mapped_start = clock::now();
+        cnf::cnf_expr mapped;
+        cnf::io::read_cnf_problem(mapped, argv[i]);
+        std::chrono::duration<double> mapped_time = clock::now() - mapped_start;
+
+        // memory-mapped parse on every hardware thread
+        const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        auto parallel_start = clock::now();
+        cnf::cnf_expr parallel;
+        cnf::io::read_cnf_problem(parallel, argv[i], threads);
+        std::chrono::duration<double> parallel_time = clock::now() - parallel_start;
+
+        // stream parse
+        std::istringstream arena_str(text);
+        auto arena_start = clock::now();
+        cnf::cnf_expr expr(arena_str);
+        std::chrono::duration<double> arena_time = clock::now() - arena_start;
+
+        // hash-map representation
+        std::istringstream legacy_str(text);
+        auto legacy_start = clock::now();
+        legacy_expr legacy;
+        legacy_parse(legacy_str, legacy);
+        std::chrono::duration<double> legacy_time = clock::now() - legacy_start;
+
+        const double megabytes = text.size() / 1e6;
+        std::cout << std::format(
+            "{}\n"
+            "  input:      {} bytes, {} clauses\n"
+            "  mapped:     {} s, {} MB/s\n"
+            "  parallel:   {} s, {} MB/s on {} threads\n"
+            "  stream:     {} s, {} MB/s\n"
+            "  hash map:   {} s, {} MB/s\n"
+            "  memory:     {} bytes arena, {} bytes hash map, {}x reduction\n",
+            argv[i],
+            text.size(), mapped.get_num_clauses(),
+            mapped_time.count(), megabytes / mapped_time.count(),
+            parallel_time.count(), megabytes / parallel_time.count(), threads,
+            arena_time.count(), megabytes / arena_time.count(),
+            legacy_time.count(), megabytes / legacy_time.count(),
+            expr.memory_usage(), allocated_bytes,
+            static_cast<double>(allocated_bytes) / expr.memory_usage()
+        );
+    } catch (std::exception& e) {
+        std::cerr << argv[i] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+// bench_sat.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+// Measures the time needed to load generated SAT-format problems of
+// increasing size into a cnf_expr.
+// Usage: bench_sat [OPERATORS...]
+
+#include "cnf.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // the number of variables in generated problems
+    constexpr int num_vars = 1000;
+
+    // a conjunction of small negated subformulas, such as
+    // -(*(-3 +(5 -8))), each holding three operators
+    std::string wide_formula(std::size_t operators) {
+        std::mt19937 rand(operators);
+        std::uniform_int_distribution<int> var_dist(1, num_vars);
+        std::bernoulli_distribution sign_dist(0.5);
+        auto lit = [&]() {
+            return (sign_dist(rand) ? "-" : "") + std::to_string(var_dist(rand));
+        };
+        std::string text = std::format("p sat {}\n*(\n", num_vars);
+        for (std::size_t i(0); i < operators / 3; i++) {
+            text += "-(*(" + lit() + " +(" + lit() + " " + lit() + ")))\n";
+        }
+        return text + ")\n";
+    }
+
+    // a conjunction of subformulas drawn from a small pool, so most of
+    // the problem repeats subformulas seen before
+    std::string repeated_formula(std::size_t operators) {
+        std::mt19937 rand(operators);
+        std::uniform_int_distribution<int> var_dist(1, num_vars);
+        std::bernoulli_distribution sign_dist(0.5);
+        auto lit = [&]() {
+            return (sign_dist(rand) ? "-" : "") + std::to_string(var_dist(rand));
+        };
+        std::vector<std::string> pool;
+        for (std::size_t i(0); i < 1000; i++) {
+            pool.push_back(
+                "+(*(" + lit() + " " + lit() + ") -(+(" + lit() + " *(" + lit() + " " + lit() + "))))"
+            );
+        }
+        std::uniform_int_distribution<std::size_t> pool_dist(0, pool.size() - 1);
+        std::string text = std::format("p sat {}\n*(\n", num_vars);
+        for (std::size_t i(0); i < operators / 5; i++) {
+            text += pool[pool_dist(rand)] + "\n";
+        }
+        return text + ")\n";
+    }
+
+    // a chain of alternating operators, each negating its own variable
+    // in a nested subformula, such as *(1 -(+(2 -(*(3 4)))))
+    std::string deep_formula(std::size_t operators) {
+        std::string text = std::format("p sat {}\n", num_vars);
+        const std::size_t depth = operators / 2;
+        for (std::size_t i(0); i < depth; i++) {
+            text += std::format("{}({} -(", i % 2 == 0 ? "*" : "+", i % num_vars + 1);
+        }
+        text += "1";
+        for (std::size_t i(0); i < depth; i++) {
+            text += "))";
+        }
+        return text + "\n";
+    }
+
+    // time loading a problem
+    void measure(const std::string& shape, std::size_t operators, const std::string& text) {
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+        cnf::cnf_expr expr{std::string_view(text)};
+        std::chrono::duration<double> elapsed = clock::now() - start;
+        std::cout << std::format(
+            "{} formula, {} operators\n"
+            "  input:      {} bytes, {} clauses\n"
+            "  load:       {} s, {} MB/s\n",
+            shape, operators,
+            text.size(), expr.get_num_clauses(),
+            elapsed.count(), text.size() / 1e6 / elapsed.count()
+        );
+    }
+
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> sizes;
+    for (int i(1); i < argc; i++) {
+        sizes.push_back(std::stoull(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {1'000, 10'000, 100'000, 1'000'000};
+    }
+    try {
+        for (const std::size_t& operators : sizes) {
+            measure("wide", operators, wide_formula(operators));
+        }
+        for (const std::size_t& operators : sizes) {
+            measure("deep", operators, deep_formula(operators));
+        }
+        for (const std::size_t& operators : sizes) {
+            measure("repeated", operators, repeated_formula(operators));
+        }
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -32,7 +32,7 @@ int main(int argc, char** argv) try {
     } else {
         // solve the provided problem
         if (pif.var_map.count("problem") > 0) {
-            return solve::run_portfolio(pif, pif.pstr, std::cout);
+            return solve::run_portfolio(pif, pif.problem_path, std::cout);
         } else {
             return solve::run_portfolio(pif, std::cin, std::cout);
         }
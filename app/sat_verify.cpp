@@ -20,7 +20,7 @@ int main(int argc, char** argv) try {
         cnf::cnf_expr expr;
         sol::solution sol;
         if (pif.var_map.count("problem") > 0) {
-            expr = pif.pstr;
+            cnf::io::read_cnf_problem(expr, pif.problem_path);
         } else {
             expr = std::cin;
         }
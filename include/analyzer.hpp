@@ -0,0 +1,46 @@
+// analyzer.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_ANALYZER
+#define INC_ANALYZER
+
+#include <vector>
+#include "cnf.hpp"
+#include "propagator.hpp"
+#include "brancher.hpp"
+#include "clause_db.hpp"
+
+namespace solver {
+
+    // Derives a learned clause from a conflict by first-UIP analysis.
+    //
+    // The conflicting clause is resolved with the reasons of its literals
+    // assigned at the current decision level, latest first, until only one
+    // such literal is left: the first unique implication point. The trail
+    // is swept backwards once, and a seen flag per variable stands in for
+    // the clause being built, so the work is linear in the trail and the
+    // reasons visited. The decision level and reason of each variable are
+    // read from the propagator.
+    class analyzer {
+    public:
+        // no default constructor
+        analyzer() = delete;
+        // problem constructor
+        analyzer(const cnf::cnf_expr&);
+        // Given a propagator and a clause it found conflicting, fill in a
+        // learned clause and return the level to backjump to. The learned
+        // clause lists its literal from the current level first, and one
+        // from the backjump level second, ready to be watched. Literals
+        // fixed at level zero are left out. Every variable resolved on or
+        // kept is bumped in the brancher, and every clause resolved in the
+        // clause store.
+        int operator()(const propagator&, clause, std::vector<literal>&, brancher&, clause_db&);
+    private:
+        // whether each variable is in the clause being built
+        std::vector<bool> seen;
+    };
+
+}
+
+#endif
@@ -0,0 +1,88 @@
+// brancher.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_BRANCHER
+#define INC_BRANCHER
+
+#include <vector>
+#include <cstdint>
+#include "cnf.hpp"
+#include "solve.hpp"
+#include "propagator.hpp"
+
+namespace solver {
+
+    // Chooses the variable of each decision.
+    //
+    // With EVSIDS, each variable has an activity, raised by an increment
+    // whenever it takes part in a conflict. The increment grows after
+    // every conflict, so older bumps count for less; activities are scaled
+    // down before they overflow. Variables are kept in a binary max-heap by
+    // activity, with the heap position of each, so a bump moves one entry.
+    //
+    // With VMTF, variables are kept in a queue, and those taking part in a
+    // conflict move to the front, in the order they were last moved. A
+    // search position, before which every variable is assigned, is kept so
+    // each decision only looks at variables that may be unassigned.
+    //
+    // The variable order uses the same queue, with no moves, so the lowest
+    // unassigned variable is always decided first.
+    //
+    // Assigned variables are left where they are, and skipped when a
+    // decision is made; they are restored before the propagator
+    // backtracks past them.
+    class brancher {
+    public:
+        // no default constructor
+        brancher() = delete;
+        // problem constructor
+        brancher(const cnf::cnf_expr&, Heuristic);
+        // note that a variable took part in a conflict
+        void bump(variable);
+        // apply the bumps noted since the last conflict; call while the
+        // bumped variables are still assigned
+        void conflict();
+        // restore the variables the propagator will unassign when it
+        // backtracks to the given level; call before it does
+        void backtrack(const propagator&, int);
+        // return an unassigned variable, or 0 if all are assigned
+        variable pick(const propagator&);
+    private:
+        // the position of a variable not in the heap
+        static constexpr std::uint32_t none = UINT32_MAX;
+        // the heuristic in use
+        Heuristic heuristic;
+        // variables bumped since the last conflict, and whether each is
+        std::vector<variable> bumped;
+        std::vector<bool> is_bumped;
+        // EVSIDS: the activity of each variable, and the current increment
+        std::vector<double> activity;
+        double increment;
+        // EVSIDS: variables by activity, and the heap position of each
+        std::vector<variable> heap;
+        std::vector<std::uint32_t> position;
+        // VMTF: the neighbours of each variable in the queue, towards the
+        // back and towards the front, and the time it was last moved
+        std::vector<variable> prev;
+        std::vector<variable> next;
+        std::vector<std::uint64_t> stamp;
+        // VMTF: the front of the queue, the search position, and the
+        // latest time
+        variable front;
+        variable search;
+        std::uint64_t time;
+        // add a variable to the heap
+        void heap_insert(variable);
+        // remove the top of the heap
+        variable heap_pop();
+        // move a heap entry towards the top or bottom until it is in order
+        void sift_up(std::uint32_t);
+        void sift_down(std::uint32_t);
+        // move a variable to the front of the queue
+        void move_to_front(variable);
+    };
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+// clause_db.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_CLAUSE_DB
+#define INC_CLAUSE_DB
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "cnf.hpp"
+#include "propagator.hpp"
+
+namespace solver {
+
+    // Keeps the clauses learned by conflict analysis, and removes those
+    // that are unlikely to be useful again.
+    //
+    // Each learned clause is given its literal block distance (LBD): the
+    // number of decision levels among its literals. Clauses with an LBD of
+    // at most two form the core and are kept for good. Those with an LBD
+    // of at most six form the second tier, and are kept while they keep
+    // taking part in conflicts; one left unused between two reductions
+    // moves to the local tier. The rest are local. A clause whose LBD
+    // drops when it is used again moves up.
+    //
+    // Each clause also has an activity, raised whenever it takes part in a
+    // conflict by an increment that grows with each conflict. The store
+    // is reduced at growing intervals of conflicts, removing the less
+    // active half of the local clauses left unused since the last
+    // reduction, other than those that are the reason of a current
+    // assignment, and compacting the propagator.
+    class clause_db {
+    public:
+        // no default constructor
+        clause_db() = delete;
+        // problem constructor
+        clause_db(const cnf::cnf_expr&);
+        // give the LBD of a clause whose literals are all assigned
+        int lbd(const propagator&, cnf::lit_span);
+        // add a learned clause with its LBD to the propagator
+        clause add(propagator&, cnf::lit_span, int);
+        // note that a clause took part in a conflict
+        void bump(const propagator&, clause);
+        // check whether the store is due to be reduced
+        bool due() const;
+        // remove the least useful local clauses
+        void reduce(propagator&);
+        // add the work done to a set of statistics
+        void report(std::map<std::string, std::string>&) const;
+    private:
+        // the tiers of learned clauses
+        enum Tier: unsigned char {
+            Core = 0,
+            Tier2 = 1,
+            Local = 2
+        };
+        // a learned clause
+        struct entry {
+            // the clause in the propagator
+            clause cl;
+            // its LBD when it was learned or last lowered
+            int lbd;
+            // its activity
+            double activity;
+            // its tier
+            Tier tier;
+            // whether it took part in a conflict since the last reduction
+            bool used;
+        };
+        // the learned clauses, each with its index as its id
+        std::vector<entry> learned;
+        // the LBD computation in which each decision level was last seen
+        std::vector<std::uint64_t> level_stamps;
+        std::uint64_t stamp;
+        // the current activity increment
+        double increment;
+        // conflicts seen, and the number at which the next reduction is due
+        std::uint64_t conflicts;
+        std::uint64_t next_reduction;
+        std::uint64_t reduction_interval;
+        // statistics
+        std::uint64_t num_learned;
+        std::uint64_t num_deleted;
+        std::uint64_t num_reductions;
+        std::uint64_t total_lbd;
+        // give the tier of a clause with the given LBD
+        static Tier tier_of(int);
+    };
+
+}
+
+#endif
@@ -6,9 +6,11 @@
 #define INC_CNF
 
 #include <map>
-#include <unordered_map>
-#include <unordered_set>
 #include <set>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <limits>
 #include <istream>
 #include <ostream>
 #include <ios>
@@ -18,35 +20,106 @@
 #include <cctype>
 #include <stack>
 #include <sstream>
+#include <string_view>
 #include "message.hpp"
 
 // a collection of types used to store CNF problems
 namespace cnf {
 
+    // used to specify how SAT formulas are converted to clauses
+    enum Encoding: bool {
+        // a new variable for each subformula; linear in the formula size
+        Tseitin = true,
+        // distribution of disjunctions; equivalent, but may be exponential
+        Expansion = false
+    };
+
     // forward declaration
     class cnf_expr;
+    struct component;
     namespace io {
-        cnf_expr& extract_cnf_problem(cnf_expr&, std::istream&);
+        cnf_expr& extract_cnf_problem(cnf_expr&, std::istream&, unsigned = 1, Encoding = Tseitin);
+        cnf_expr& extract_cnf_problem(cnf_expr&, std::string_view, unsigned = 1, Encoding = Tseitin);
+        cnf_expr& read_cnf_problem(cnf_expr&, const std::string&, unsigned = 1, Encoding = Tseitin);
+        cnf_expr& extract_compressed_problem(cnf_expr&, std::string_view, unsigned, Encoding);
+        cnf_expr& load_binary_problem(cnf_expr&, std::string_view);
+        bool write_binary_problem(const cnf_expr&, const std::string&);
     }
 
     // a boolean variable; strictly positive
     using variable = int;
 
-    // a disjunctive clause; strictly positive
-    using clause = int;
+    // a disjunctive clause; refers to the clause's offset in the arena
+    using clause = std::uint32_t;
 
     // a boolean literal; negative values indicate negation
     // is never zero
     using literal = int;
 
-    // a collection of literals
-    using lit_set = std::unordered_set<literal>;
+    // a view of the active literals in a clause
+    using lit_span = std::span<const literal>;
 
     // a collection of clauses
-    using cl_set = std::unordered_set<clause>;
+    using cl_list = std::vector<clause>;
+
+    // marks the absence of a clause
+    constexpr clause no_clause = std::numeric_limits<clause>::max();
 
-    // a map of variables to their proposed value
-    using solution = std::map<variable, bool>;
+    // index of a literal in per-literal tables
+    // a variable's positive literal is at 2 * var, its negation just after
+    inline std::size_t lit_index(literal lit) {
+        return 2 * static_cast<std::size_t>(lit < 0 ? -lit : lit) + (lit < 0);
+    }
+
+    // a proposed value for each variable
+    //
+    // One bit is kept per literal, set when the literal is true, so testing
+    // a literal is a single lookup. Both bits of an unassigned variable are
+    // clear.
+    class assignment {
+    public:
+        // default constructor
+        assignment() = default;
+        // make room for variables up to the given one
+        explicit assignment(variable max_var): bits(2 * (static_cast<std::size_t>(max_var) + 1), false) {}
+        // check whether a literal is true
+        bool is_true(literal lit) const {
+            const std::size_t idx = lit_index(lit);
+            return idx < bits.size() && bits[idx];
+        }
+        // check whether a variable has a value
+        bool is_assigned(variable var) const {
+            return is_true(var) || is_true(-var);
+        }
+        // make a literal true, assigning its variable
+        void assign(literal lit) {
+            const std::size_t idx = lit_index(lit);
+            if (idx >= bits.size()) {
+                bits.resize((idx | 1) + 1, false);
+            }
+            bits[idx] = true;
+            bits[idx ^ 1] = false;
+        }
+        // remove the value of a variable
+        void unassign(variable var) {
+            if (lit_index(-var) < bits.size()) {
+                bits[lit_index(var)] = false;
+                bits[lit_index(-var)] = false;
+            }
+        }
+        // negate the value of an assigned variable
+        void flip(variable var) {
+            bits[lit_index(var)].flip();
+            bits[lit_index(-var)].flip();
+        }
+        // give the largest variable that can be stored without growing
+        variable get_max_var() const {
+            return bits.empty() ? 0 : bits.size() / 2 - 1;
+        }
+    private:
+        // the truth value of each literal, indexed by lit_index
+        std::vector<bool> bits;
+    };
 
     // used to specify the problem format
     enum ProblemType: bool {
@@ -55,12 +128,27 @@ namespace cnf {
     };
 
     // a complete boolean CNF expression
+    //
+    // Clauses are stored contiguously in a single arena: each clause is a
+    // header followed by its literals, and is referred to by the 32-bit
+    // offset of its header. Literals removed from a clause are swapped past
+    // the end of its active region, so the active literals always come first.
+    // Every removal is logged, so simplifications can be undone in reverse.
+    // Per-literal occurrence counts are kept up to date as clauses shrink,
+    // and clauses that become unit and literals that become pure are queued
+    // as it happens, so neither needs to be searched for.
+    //
+    // Variables above the maximum given by the problem are introduced by
+    // the encoding of a SAT formula. Each is defined as the conjunction or
+    // disjunction of other literals, so its value follows from theirs.
     class cnf_expr {
     public:
         // default constructor
-        cnf_expr() = default;
+        cnf_expr();
         // input stream constructor
         cnf_expr(std::istream&);
+        // problem text constructor
+        cnf_expr(std::string_view);
         // copy constructor
         cnf_expr(const cnf_expr&) = default;
         // move constructor
@@ -68,62 +156,202 @@ namespace cnf {
         // assignment
         cnf_expr& operator=(const cnf_expr&) = default;
         cnf_expr& operator=(cnf_expr&&) = default;
-        // add a literal to a clause
-        void add_literal(literal, clause);
+        // add a clause
+        clause add_clause(lit_span);
+        // record a variable as appearing in the expression
+        void add_variable(variable);
+        // introduce a variable beyond those named by the problem
+        variable new_variable();
+        // define an introduced variable as a conjunction or disjunction
+        void define_variable(variable, bool, lit_span);
+        // give values to introduced variables from their definitions
+        void extend(assignment&) const;
         // remove a literal from a clause
         void remove_literal(literal, clause);
         // remove a redundant variable from the record
         void remove_variable(variable);
         // remove an entire clause
         void remove_clause(clause);
+        // remove every clause, keeping the record of variables, so a
+        // simplified set of clauses can be added in their place
+        void clear_clauses();
         // assign a variable and simplify the expression
         void assign_and_simplify(variable, bool);
-        // return an iterator to a unit clause
-        std::unordered_map<clause, lit_set>::const_iterator unit_clause() const;
-        // return a pure literal
-        literal pure_literal() const;
-        // end iterators for the maps
-        std::unordered_map<literal, cl_set>::const_iterator literals_end() const;
-        std::unordered_map<clause, lit_set>::const_iterator clauses_end() const;
+        // give a mark to which later removals can be undone
+        std::size_t checkpoint() const;
+        // undo every removal made since the given mark
+        void undo(std::size_t);
+        // return a queued unit clause
+        clause unit_clause();
+        // return a queued pure literal
+        literal pure_literal();
         // give the number of active clauses
         std::size_t get_num_clauses() const;
+        // give the number of clauses in the problem as it was read
+        std::size_t get_num_input_clauses() const;
+        // give the number of tautologies removed while reading the problem
+        std::size_t num_tautologies() const;
+        // give the number of duplicate clauses removed while reading the problem
+        std::size_t num_duplicates() const;
         // give the number of active variables
         std::size_t num_variables() const;
         // give the maximum variable key
         variable get_max_var() const;
+        // give the maximum variable named by the problem
+        variable get_max_input_var() const;
         // evaluate the expression
-        bool eval(const std::map<variable, bool>& assigns) const;
+        bool eval(const assignment&) const;
         // return a set of the expression's variables
         std::set<variable> variables() const;
         // return a set of unsatisfied clauses
-        std::set<clause> unsatisfied_clauses(const std::map<variable, bool>&) const;
+        cl_list unsatisfied_clauses(const assignment&) const;
         // check for empty clauses
         bool empty_clause() const;
-        // return a reference to the requested clause
-        const lit_set& get_clause(clause) const;
-        // return a reference to the clause list of the requested literal
-        const cl_set& get_literal(literal) const;
+        // return the active literals of the requested clause
+        lit_span get_clause(clause) const;
+        // return the clauses containing the requested literal
+        const cl_list& get_literal(literal) const;
+        // return the list of active clauses
+        const cl_list& get_clauses() const;
         // return an active variable
         variable pick_var() const;
+        // check whether a variable appears in an active clause
+        bool is_active(variable) const;
         // get the problem type
         ProblemType get_type() const;
         // find an empty clause
         clause get_empty_clause() const;
-        // find highest-numbered clause
-        clause get_max_clause() const;
+        // give the number of bytes used to store the expression
+        std::size_t memory_usage() const;
+        // split the clauses into parts that share no variables; gives
+        // nothing if they cannot be split
+        std::vector<component> components() const;
     private:
+        // words in a clause header: the active size, the position in the
+        // list of active clauses, and whether it is in the unit queue
+        static constexpr std::size_t header_size = 3;
+        // list position of a removed clause
+        static constexpr literal removed = -1;
+        // clause headers and literals
+        std::vector<literal> arena;
+        // the active clauses, in order of insertion
+        cl_list clauses;
         // tracks which clauses a given literal is in
-        std::unordered_map<literal, cl_set> literals;
-        // tracks which literals are in a given clause
-        std::unordered_map<clause, lit_set> clauses;
+        std::vector<cl_list> literals;
+        // number of active clauses in which each literal is active
+        std::vector<std::uint32_t> counts;
+        // clauses that may have become unit
+        cl_list unit_queue;
+        // literals that may have become pure
+        std::vector<literal> pure_queue;
+        // whether each literal is in the pure queue
+        std::vector<bool> pure_queued;
+        // tracks which variables appear in the expression
+        std::vector<bool> present;
+        // number of variables present
+        std::size_t num_present;
+        // number of active clauses with no active literals
+        std::size_t num_empty;
+        // number of clauses read, and how many of them were removed
+        std::size_t num_input_clauses;
+        std::size_t num_removed_tautologies;
+        std::size_t num_removed_duplicates;
+        // removed literals and clauses, in order; a zero literal marks a clause
+        std::vector<std::pair<clause, literal>> undo_log;
         // maximum variable value
         variable max_var;
+        // maximum variable named by the problem
+        variable max_input_var;
+        // introduced variables, each followed by whether it is a
+        // conjunction, the number of its literals, and the literals
+        std::vector<literal> definitions;
         // format of provided problem
         ProblemType type;
+        // make room for the given variable
+        void reserve_variable(variable);
+        // release unused capacity once the expression is built
+        void shrink_to_fit();
+        // sort the clauses of a freshly parsed expression and remove
+        // tautologies and duplicates
+        void normalize();
+        // build the occurrence lists of a freshly parsed expression
+        void index_occurrences();
+        // build a clause in place at the end of the arena
+        clause open_clause();
+        void append_literal(clause, literal);
+        void close_clause(clause);
+        // parse part of a CNF body into a separate block of clauses
+        void parse_block(const char*, const char*, std::vector<literal>&) const;
+        // append a block of parsed clauses
+        void append_block(lit_span);
+        // queue a clause that may have become unit
+        void queue_unit(clause);
+        // queue a literal that may have become pure
+        void queue_pure(literal);
+        // count or discount an active occurrence of a literal
+        void count_literal(literal);
+        void discount_literal(literal);
         // used to print cnf_expr
         friend std::ostream& operator<<(std::ostream&, const cnf_expr&);
-        // used to build problem from input stream
-        friend cnf_expr& io::extract_cnf_problem(cnf_expr&, std::istream&);
+        // used to build problem from problem text
+        friend cnf_expr& io::extract_cnf_problem(cnf_expr&, std::string_view, unsigned, Encoding);
+        friend cnf_expr& io::extract_compressed_problem(cnf_expr&, std::string_view, unsigned, Encoding);
+        // used to store and reload a parsed problem
+        friend cnf_expr& io::load_binary_problem(cnf_expr&, std::string_view);
+        friend bool io::write_binary_problem(const cnf_expr&, const std::string&);
+    };
+
+    // an independent part of an expression
+    //
+    // The variables of the part are numbered from one, so solvers size
+    // their tables by the part rather than by the whole expression.
+    struct component {
+        // the clauses of the part
+        cnf_expr expr;
+        // the variable of the whole expression for each variable of the
+        // part; the first entry is unused
+        std::vector<variable> variables;
+    };
+
+}
+
+namespace cnf::io {
+
+    // read the remainder of a stream
+    std::string read_stream(std::istream&);
+
+    // check whether problem text is a binary problem
+    bool is_binary_problem(std::string_view);
+
+    // give the file name under which a problem is cached, from the hash of
+    // its text and the encoding used to read it
+    std::string cache_name(std::string_view, Encoding);
+
+    // the read-only contents of a file
+    //
+    // Regular files are memory mapped, so their text is parsed in place
+    // without being copied. Files that cannot be mapped, such as pipes,
+    // are read into a buffer instead.
+    class file_view {
+    public:
+        // no default constructor
+        file_view() = delete;
+        // path constructor
+        file_view(const std::string&);
+        // no copying
+        file_view(const file_view&) = delete;
+        file_view& operator=(const file_view&) = delete;
+        // destructor
+        ~file_view();
+        // give the contents of the file
+        std::string_view contents() const;
+    private:
+        // the mapped file, if it could be mapped
+        void* map;
+        // the size of the file
+        std::size_t size;
+        // the file contents, if it could not be mapped
+        std::string buffer;
     };
 
 }
@@ -0,0 +1,74 @@
+// compressed.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_COMPRESSED
+#define INC_COMPRESSED
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <thread>
+
+// a collection of types used to read compressed problems
+namespace cnf::io {
+
+    // the compression formats that can be recognised
+    enum class compression {
+        None,
+        Gzip,
+        Xz
+    };
+
+    // recognise the compression of some data from its magic bytes
+    compression detect_compression(std::string_view);
+
+    // check whether this build can decompress a format
+    bool can_decompress(compression);
+
+    // a stream of decompressed text, produced on its own thread
+    //
+    // The worker decompresses into blocks of about a megabyte and hands
+    // them over through a queue of bounded length, so the reader can
+    // tokenize one block while the next is being decompressed, and a
+    // slow reader holds back the worker rather than filling memory.
+    class decompressor {
+    public:
+        // no default constructor
+        decompressor() = delete;
+        // compressed data constructor; the data must outlive the decompressor
+        decompressor(std::string_view);
+        // no copying
+        decompressor(const decompressor&) = delete;
+        decompressor& operator=(const decompressor&) = delete;
+        // give the next block of text; returns false once all text is given
+        // rethrows any error encountered while decompressing
+        bool next(std::string&);
+    private:
+        // decompress the data into the queue
+        void run(std::stop_token);
+        // hand a finished block to the reader, waiting for room
+        bool deliver(std::stop_token, std::string&);
+        // the compressed data
+        std::string_view data;
+        // the format of the data
+        compression format;
+        // blocks waiting to be read
+        std::deque<std::string> blocks;
+        // whether the worker has finished
+        bool finished;
+        // an error encountered by the worker
+        std::exception_ptr error;
+        // guards the queue
+        std::mutex m;
+        std::condition_variable_any changed;
+        // the worker; started last, and stopped and joined first
+        std::jthread worker;
+    };
+
+}
+
+#endif
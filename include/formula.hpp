@@ -0,0 +1,112 @@
+// formula.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_FORMULA
+#define INC_FORMULA
+
+#include <vector>
+#include <span>
+#include <cstdint>
+#include "cnf.hpp"
+
+// a collection of types used to process SAT problems
+namespace cnf::sat {
+
+    // refers to a node by its position in a formula
+    using node_id = std::uint32_t;
+
+    // refers to a node or its negation: twice the node's position, plus
+    // one if negated
+    using edge = std::uint32_t;
+
+    // the constant node is false, so its negation is true
+    constexpr edge false_edge = 0;
+    constexpr edge true_edge = 1;
+
+    // give the node an edge refers to
+    inline node_id node_of(edge e) {
+        return e >> 1;
+    }
+
+    // check whether an edge negates its node
+    inline bool is_negated(edge e) {
+        return e & 1;
+    }
+
+    // the operation performed by a formula node
+    enum class op: std::uint8_t {
+        Const,
+        Var,
+        And
+    };
+
+    // a node of a formula
+    struct node {
+        // the operation
+        op kind;
+        // the variable of a variable node
+        variable var;
+        // position and number of the children in the edge list
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    // a boolean formula, stored as an and-inverter graph
+    //
+    // Every formula is a variable, a constant, or a conjunction, reached
+    // through an edge that may negate it; disjunctions are negated
+    // conjunctions of negated children. Nodes are hash-consed, so equal
+    // subformulas are stored once, and each conjunction is simplified as
+    // it is added: constants are folded, repeated children are merged,
+    // small child conjunctions are flattened into it, and a child next
+    // to its own negation makes it false. Children are always added
+    // before their parents.
+    class formula {
+    public:
+        // default constructor
+        formula();
+        // give the edge for a literal
+        edge add_literal(literal);
+        // give the edge for a conjunction or disjunction of edges
+        edge add_operator(bool, std::span<const edge>);
+        // give the negation of an edge
+        edge add_negation(edge) const;
+        // give a node
+        const node& get_node(node_id) const;
+        // give the children of a node
+        std::span<const edge> get_children(node_id) const;
+        // give the number of nodes
+        std::size_t size() const;
+    private:
+        // the nodes, children first
+        std::vector<node> nodes;
+        // the children of every node
+        std::vector<edge> edges;
+        // the node of each variable, or 0 if it has none
+        std::vector<node_id> var_nodes;
+        // open-addressed table of conjunctions, by the hash of their
+        // children; 0 marks an empty slot
+        std::vector<node_id> unique;
+        // number of conjunctions in the table
+        std::size_t num_unique;
+        // children gathered for the conjunction being added
+        std::vector<edge> scratch;
+        // give the hash of a list of children
+        static std::uint64_t hash_children(std::span<const edge>);
+    };
+
+    // parse the body of a SAT problem into a formula; returns the root
+    edge parse_formula(formula&, const char*, const char*, variable);
+
+    // add the clauses of a formula to an expression by distributing
+    // disjunctions over conjunctions
+    void expand_formula(const formula&, edge, cnf_expr&);
+
+    // add clauses for a formula to an expression, introducing a variable
+    // for each conjunction that is not asserted directly
+    void encode_formula(const formula&, edge, cnf_expr&);
+
+}
+
+#endif
@@ -23,9 +23,24 @@ namespace err {
     const std::string too_many_cl_var(
         "the number of clauses and/or variables must not exceed the signed 32-bit integer."
     );
+    const std::string expression_size(
+        "the problem expression is too large to be stored."
+    );
     const std::string io_err(
         "an I/O Error was encountered while parsing input"
     );
+    const std::string binary_format(
+        "the binary problem is corrupt or was written by another version."
+    );
+    const std::string cache_dir(
+        "the cache directory could not be created."
+    );
+    const std::string compression_unsupported(
+        "the problem is compressed in a format this build cannot read."
+    );
+    const std::string compressed_format(
+        "the compressed problem is corrupt or truncated."
+    );
     const std::string num_clauses_vars(
         "the number of variables and/or clauses must be strictly positive."
     );
@@ -77,6 +92,12 @@ namespace err {
     const std::string invalid_solver(
         "the requested solver does not exist."
     );
+    const std::string invalid_heuristic(
+        "the requested branching heuristic does not exist."
+    );
+    const std::string invalid_restarts(
+        "the restart policies must be a comma-separated list of existing policies."
+    );
     const std::string type_mismatch(
         "the type of the problem and solution must be the same."
     );
@@ -200,6 +221,51 @@ namespace info {
             "   'g': gigabytes\n"
             "   (default is '2g')"
         );
+        const std::string cache_dir(
+            "keep parsed problems in binary form in the provided directory,\n"
+            "   and reload them from it when the same problem is given again"
+        );
+        const std::string expand(
+            "convert SAT formulas to clauses by distributing disjunctions,\n"
+            "   without introducing variables; the clauses may grow\n"
+            "   exponentially with the formula"
+        );
+        const std::string no_preprocess(
+            "solve the problem as it was read, without first simplifying it\n"
+            "   by equivalent literal substitution, probing, blocked clause\n"
+            "   elimination, variable elimination, subsumption, and bounded\n"
+            "   variable addition"
+        );
+        const std::string preprocess_time(
+            "the maximum wall time preprocessing may use, in the same form\n"
+            "   as '--duration'; half of it may go to equivalent literal\n"
+            "   substitution and probing\n"
+            "   (default is a tenth of the duration)"
+        );
+        const std::string symmetry(
+            "find symmetries of the problem after preprocessing and add\n"
+            "   clauses so only one of each set of symmetric solutions is\n"
+            "   searched; this takes at most what preprocessing leaves of\n"
+            "   its time limit"
+        );
+        const std::string branching(
+            "the heuristic the dpll and cdcl solvers use to choose each\n"
+            "   decision variable; options are\n"
+            "   vsids: the variable most involved in recent conflicts\n"
+            "       (default)\n"
+            "   vmtf: the variable most recently involved in a conflict\n"
+            "   order: the lowest unassigned variable"
+        );
+        const std::string restarts(
+            "the restart policies of the cdcl solver threads, separated by\n"
+            "   commas and given to the threads in turn; options are\n"
+            "   glucose: restart when recent learned clauses are worse than\n"
+            "       usual, unless the trail is unusually long\n"
+            "   luby: restart after a Luby sequence of conflicts\n"
+            "   geometric: restart after geometrically growing numbers of conflicts\n"
+            "   never: do not restart\n"
+            "   (default is 'glucose,luby,geometric')"
+        );
     }
 
 }
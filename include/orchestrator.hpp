@@ -16,6 +16,7 @@
 #include "sol.hpp"
 #include "cnf.hpp"
 #include "solve.hpp"
+#include "preprocess.hpp"
 
 namespace solve {
 
@@ -42,16 +43,27 @@ namespace solve {
         // no assignment
         orchestrator& operator=(const orchestrator&) = delete;
         orchestrator& operator=(orchestrator&&) = delete;
-        // run the solvers
-        std::pair<Status, sol::solution> operator()(const cnf::cnf_expr&);
+        // run the solvers on a preprocessed expression
+        std::pair<Status, sol::solution> operator()(const cnf::cnf_expr&, const preprocess::preprocessor&);
         // report solution
         void report_solution(sol::solution&&, solver::SolverType);
         // report no solution
         void report_no_solution();
         // report solver error
         void report_error(bool);
+        // stop the solvers early, without a result
+        void cancel();
     private:
+        // component constructor, with a share of the threads and the
+        // deadline of the whole problem
+        orchestrator(const program_interface&, uint, std::chrono::steady_clock::time_point);
+        // run the solvers on an expression until one finishes
+        void search(const cnf::cnf_expr&);
+        // run the solvers on each independent part of an expression
+        void search_components(std::vector<cnf::component>&);
         std::vector<std::jthread> threads;
+        uint num_threads;
+        std::chrono::steady_clock::time_point deadline;
         uint active_divided_threads;
         uint active_incomplete_threads;
         sol::solution sol;
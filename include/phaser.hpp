@@ -0,0 +1,88 @@
+// phaser.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_PHASER
+#define INC_PHASER
+
+#include <map>
+#include <string>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <stop_token>
+#include "cnf.hpp"
+#include "propagator.hpp"
+
+namespace solver {
+
+    // Chooses the value each decision gives its variable.
+    //
+    // When a variable is unassigned by backtracking, its value is saved
+    // as its phase, and a later decision on it gives it the same value,
+    // so the progress made towards a solution is kept across backjumps.
+    //
+    // The longest trail reached without a conflict is kept as the target
+    // phase, and followed in preference to the saved phase; the longest
+    // since the last rephase to it is kept as the best phase.
+    //
+    // At growing intervals of conflicts, the saved phases are all reset,
+    // in turn to the original phase (false), the best phase, the inverted
+    // phase (true), the best, random values, the best, the result of a
+    // local search walk from the saved phases, and the best again. The
+    // target phase starts over after each rephase.
+    class phaser {
+    public:
+        // no default constructor
+        phaser() = delete;
+        // problem constructor; the expression is walked when rephasing,
+        // and must outlive the phaser
+        phaser(const cnf::cnf_expr&);
+        // give the literal a decision on a variable should assign
+        literal decide(variable) const;
+        // save the phases of the variables the propagator will unassign
+        // when it backtracks to the given level, and update the target
+        // and best phases; call before it does
+        void backtrack(const propagator&, int);
+        // note a conflict
+        void conflict();
+        // check whether a rephase is due
+        bool due() const;
+        // reset the saved phases; a walk stops early if a stop is requested
+        void rephase(std::stop_token);
+        // add the work done to a set of statistics
+        void report(std::map<std::string, std::string>&) const;
+    private:
+        // the phases the saved phases may be reset to
+        enum Phase: unsigned char {
+            Original = 0,
+            Inverted = 1,
+            Random = 2,
+            Best = 3,
+            Walk = 4
+        };
+        // the clauses to walk
+        const cnf::cnf_expr& expr;
+        // the saved, target and best value of each variable: 1 if true,
+        // -1 if false, and 0 if there is none
+        std::vector<signed char> saved;
+        std::vector<signed char> target;
+        std::vector<signed char> best;
+        // the length of the trails the target and best phases were taken from
+        std::size_t target_size;
+        std::size_t best_size;
+        // conflicts seen, and the number at which the next rephase is due
+        std::uint64_t conflicts;
+        std::uint64_t next_rephase;
+        // random values for rephasing and walking
+        std::mt19937_64 rand;
+        // statistics
+        std::uint64_t num_rephases;
+        std::uint64_t num_walks;
+        // reset the saved phases to the result of a local search walk
+        void walk(std::stop_token);
+    };
+
+}
+
+#endif
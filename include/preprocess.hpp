@@ -0,0 +1,173 @@
+// preprocess.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_PREPROCESS
+#define INC_PREPROCESS
+
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include "cnf.hpp"
+#include "sol.hpp"
+
+// a collection of types used to simplify problems before they are solved
+namespace preprocess {
+
+    using cnf::variable;
+    using cnf::literal;
+
+    // simplifies an expression before search, in the style of SatELite
+    //
+    // The clauses are copied into a store of their own, with occurrence
+    // lists for both literals of each variable, and simplified by unit
+    // propagation, subsumption, self-subsuming resolution, and bounded
+    // variable elimination. A variable is eliminated only if replacing
+    // its clauses with their non-tautological resolvents does not add
+    // clauses. The clauses left are then put back into the expression.
+    //
+    // Blocked clauses are removed before elimination, and afterwards
+    // bounded variable addition introduces a variable wherever that
+    // replaces a product of clauses, such as the pairwise clauses of an
+    // at-most-one constraint, with a sum. Added variables come after
+    // those of the expression and are not reported in solutions.
+    //
+    // Before all of that, the binary clauses are read as an implication graph.
+    // The literals of each strongly connected component are equivalent,
+    // so every variable in one is replaced by the component's smallest
+    // variable. Literals are then probed: each is assumed and propagated,
+    // and one that leads to a conflict is failed, so its negation holds.
+    // A literal implied by both signs of a variable also holds, and a
+    // literal implied through a longer clause is kept as a hyper-binary
+    // resolvent, so later probes reach it directly.
+    //
+    // Every clause removed by elimination, substitution, or propagation
+    // is pushed onto an extension stack together with a witness literal.
+    // A solution of the simplified expression is extended to the removed
+    // variables by visiting the stack in reverse and making the witness
+    // true whenever its clause is not yet satisfied.
+    //
+    // Each pass stops when the time limit is reached, with substitution
+    // and probing given the first half of it. Variables with many
+    // occurrences are neither eliminated nor used to find subsumed
+    // clauses, so preprocessing never dominates the run.
+    class preprocessor {
+    public:
+        // no default constructor
+        preprocessor() = delete;
+        // time limit constructor
+        preprocessor(std::chrono::steady_clock::duration);
+        // no copying
+        preprocessor(const preprocessor&) = delete;
+        preprocessor& operator=(const preprocessor&) = delete;
+        // simplify an expression in place
+        void operator()(cnf::cnf_expr&);
+        // give values to removed variables in a solution of the
+        // simplified expression
+        void extend(sol::solution&) const;
+        // add the reductions made to a set of statistics
+        void report(std::map<std::string, std::string>&) const;
+        // give the number of variables removed
+        std::size_t num_removed_variables() const;
+    private:
+        // a clause in the store
+        struct entry {
+            // the literals, sorted by lit_index
+            std::vector<literal> lits;
+            // a bit for each variable, modulo 64, for quick subset tests
+            std::uint64_t signature;
+            // whether the clause was removed
+            bool removed;
+            // whether the clause is waiting to be checked for subsumption
+            bool queued;
+        };
+        // the clauses
+        std::vector<entry> store;
+        // the clauses of each literal, indexed by lit_index; may hold
+        // removed clauses until they are cleaned
+        std::vector<std::vector<std::uint32_t>> occurs;
+        // values assumed while probing
+        cnf::assignment probed;
+        // variables that no longer appear in the clauses
+        std::vector<bool> eliminated;
+        // variables whose clauses changed since they were last considered
+        // for elimination
+        std::vector<bool> touched;
+        // unit clauses waiting to be propagated
+        std::vector<std::uint32_t> unit_queue;
+        // clauses waiting to be checked for subsumption
+        std::vector<std::uint32_t> subsumption_queue;
+        // removed clauses, each with its witness first, followed by its size
+        std::vector<literal> extension;
+        // the time allowed, and when it runs out
+        std::chrono::steady_clock::duration limit;
+        std::chrono::steady_clock::time_point deadline;
+        // number of limit checks made, so the clock is read only sometimes
+        std::size_t checks;
+        // whether the time ran out
+        bool timed_out;
+        // whether the clauses were found unsatisfiable
+        bool unsat;
+        // whether an expression was simplified
+        bool ran;
+        // reductions made
+        std::size_t num_fixed;
+        std::size_t num_eliminated;
+        std::size_t num_subsumed;
+        std::size_t num_strengthened;
+        std::size_t num_substituted;
+        std::size_t num_failed;
+        std::size_t num_hyper_binary;
+        std::size_t num_blocked;
+        std::size_t num_added_variables;
+        double seconds;
+        // copy the clauses of an expression into the store
+        void load(const cnf::cnf_expr&);
+        // put the clauses left back into the expression
+        void store_back(cnf::cnf_expr&) const;
+        // check whether the time limit was reached
+        bool out_of_time();
+        // add a clause to the store; its literals must be sorted
+        void add(std::vector<literal>&&);
+        // remove a clause from the store
+        void remove(std::uint32_t);
+        // remove a literal from a clause in the store
+        void strengthen(std::uint32_t, literal);
+        // push a removed clause onto the extension stack
+        void push_extension(literal, const std::vector<literal>&);
+        // remove the removed clauses from the occurrence lists of a literal
+        std::vector<std::uint32_t>& clean(literal);
+        // propagate the queued unit clauses
+        void propagate();
+        // replace each class of equivalent literals with one of them
+        void substitute();
+        // replace a variable with an equivalent literal
+        void substitute_variable(variable, literal);
+        // probe variables for failed literals and hyper-binary resolvents
+        void probe();
+        // assume a literal and propagate it; returns false on a conflict
+        bool probe_literal(literal, std::vector<literal>&, std::vector<literal>&);
+        // remove every blocked clause
+        void block();
+        // introduce a variable after those in the store
+        variable new_variable();
+        // try bounded variable addition on every literal
+        void add_variables();
+        // try to replace the clauses sharing remainders with a literal
+        bool add_variable(literal);
+        // remove and strengthen clauses using the queued clauses
+        void subsume();
+        // check whether one clause subsumes or strengthens another
+        std::optional<literal> subsumes(const entry&, const entry&) const;
+        // try to eliminate every touched variable
+        bool eliminate();
+        // try to eliminate a variable
+        bool eliminate_variable(variable);
+    };
+
+}
+
+#endif
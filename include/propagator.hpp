@@ -0,0 +1,125 @@
+// propagator.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_PROPAGATOR
+#define INC_PROPAGATOR
+
+#include <vector>
+#include <cstdint>
+#include "cnf.hpp"
+
+namespace solver {
+
+    // a boolean variable; strictly positive
+    using variable = cnf::variable;
+
+    // a disjunctive clause; refers to the clause's offset in a clause store
+    using clause = cnf::clause;
+
+    // a boolean literal; negative values indicate negation
+    // is never zero
+    using literal = cnf::literal;
+
+    // A unit propagation engine based on two watched literals.
+    //
+    // The propagator keeps its own copy of the clauses, with the two watched
+    // literals of each clause in its first two positions. Assignments are
+    // recorded on a trail, split into decision levels, and the part of the
+    // trail that has not yet been propagated acts as the propagation queue.
+    //
+    // Each clause carries an id, which whoever added it may use to find
+    // its own record of the clause. Clauses can be removed, and the store
+    // is then compacted, which moves the clauses left.
+    class propagator {
+    public:
+        // the id of a clause with no owner
+        static constexpr int no_id = -1;
+        // no default constructor
+        propagator() = delete;
+        // problem constructor
+        propagator(const cnf::cnf_expr&);
+        // copy constructor
+        propagator(const propagator&) = default;
+        // move constructor
+        propagator(propagator&&) = default;
+        // assignment
+        propagator& operator=(const propagator&) = default;
+        propagator& operator=(propagator&&) = default;
+        // add a clause, watching its first two literals
+        clause add_clause(cnf::lit_span, int = no_id);
+        // mark a clause as removed; it must not be the reason of an
+        // assignment, and the store must be compacted before propagating
+        void remove_clause(clause);
+        // drop the removed clauses and move the others together, updating
+        // the given clauses to their new positions
+        void collect(std::vector<clause>&);
+        // begin a new decision level
+        void new_level();
+        // assign a literal with the clause that implied it
+        bool enqueue(literal, clause = cnf::no_clause);
+        // propagate queued assignments; returns a conflicting clause
+        clause propagate();
+        // undo every assignment above the given decision level
+        void backtrack(int);
+        // give the value of a literal: 1 if true, -1 if false, 0 if unassigned
+        int value(literal) const;
+        // give the current decision level
+        int level() const;
+        // give the decision level at which a variable was assigned
+        int level_of(variable) const;
+        // give the clause that implied a variable's value
+        clause reason_of(variable) const;
+        // check whether a clause implied a current assignment
+        bool is_reason(clause) const;
+        // give or change the id of a stored clause
+        int id_of(clause) const;
+        void set_id(clause, int);
+        // return the literals of a stored clause
+        cnf::lit_span get_clause(clause) const;
+        // give the assignment trail
+        const std::vector<literal>& get_trail() const;
+        // give the number of assignments propagated so far
+        std::uint64_t num_propagations() const;
+        // give the number of watch list entries visited so far
+        std::uint64_t num_watch_visits() const;
+    private:
+        // an entry in a watch list
+        struct watcher {
+            // the watching clause
+            clause cl;
+            // a literal of the clause; if true, the clause need not be visited
+            literal blocker;
+        };
+        // words before the literals of a clause: its size and its id
+        static constexpr std::size_t header_size = 2;
+        // the id of a removed clause
+        static constexpr int removed_id = -2;
+        // clause headers followed by their literals
+        std::vector<literal> arena;
+        // clauses watching each literal, visited when it becomes false
+        std::vector<std::vector<watcher>> watches;
+        // value of each literal, indexed by lit_index
+        std::vector<signed char> values;
+        // decision level of each variable
+        std::vector<int> levels;
+        // reason clause of each variable
+        std::vector<clause> reasons;
+        // assigned literals, in order of assignment
+        std::vector<literal> trail;
+        // trail position at which each decision level begins
+        std::vector<std::size_t> trail_lim;
+        // next trail position to propagate
+        std::size_t queue_head;
+        // a clause that was falsified when it was added
+        clause conflict;
+        // statistics
+        std::uint64_t propagations;
+        std::uint64_t watch_visits;
+        // literals of a stored clause
+        literal* clause_literals(clause);
+    };
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+// restarter.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_RESTARTER
+#define INC_RESTARTER
+
+#include <map>
+#include <string>
+#include <cstdint>
+#include "solve.hpp"
+
+namespace solver {
+
+    // Decides when the CDCL solver should undo every decision and start
+    // its search again, keeping what it has learned.
+    //
+    // With the Luby policy, the number of conflicts between restarts
+    // follows the Luby sequence 1, 1, 2, 1, 1, 2, 4, ..., times a unit.
+    // With the geometric policy, it starts at the unit and grows by a
+    // constant factor after each restart.
+    //
+    // The Glucose policy follows two moving averages of the LBD of the
+    // learned clauses, one fast and one slow. When recent clauses are
+    // noticeably worse than usual, the search is assumed to be stuck and
+    // restarts. A restart is blocked when the trail at a conflict is much
+    // longer than usual, as the solver may then be close to a solution.
+    class restarter {
+    public:
+        // no default constructor
+        restarter() = delete;
+        // policy constructor
+        restarter(Restarts);
+        // note a conflict, with the LBD of the clause learned and the
+        // length of the trail when it was found
+        void conflict(int, std::size_t);
+        // check whether a restart is due
+        bool due() const;
+        // note that the solver restarted
+        void restart();
+        // add the work done to a set of statistics
+        void report(std::map<std::string, std::string>&) const;
+    private:
+        // an exponential moving average; it averages every value seen
+        // while it has seen fewer than the inverse of its weight, so
+        // early values are not biased towards zero
+        struct average {
+            double value;
+            double weight;
+            std::uint64_t count;
+            void update(double);
+        };
+        // the policy in use
+        Restarts policy;
+        // conflicts since the last restart, and the number due
+        std::uint64_t conflicts;
+        std::uint64_t limit;
+        // Luby: the position in the sequence
+        std::uint64_t luby_index;
+        // Glucose: averages of the LBD and of the trail length
+        average fast_lbd;
+        average slow_lbd;
+        average trail;
+        // conflicts in total
+        std::uint64_t total_conflicts;
+        // statistics
+        std::uint64_t num_restarts;
+        std::uint64_t num_blocked;
+    };
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include <ios>
 #include <stdexcept>
 #include <format>
+#include "cnf.hpp"
 #include "message.hpp"
 
 // a collection of types used to store CNF problems
@@ -42,7 +43,7 @@ namespace sol {
     class solution {
     public:
         // default constructor
-        solution(): valid(false) {};
+        solution(): num_assigned(0), valid(false) {};
         // stream constructor
         solution(std::istream&);
         // copy constructor
@@ -58,6 +59,10 @@ namespace sol {
         bool unassign_variable(variable);
         // reassign a variable
         void reassign_variable(variable, bool);
+        // negate the value of an assigned variable
+        void flip_variable(variable);
+        // remove every variable above the given one
+        void truncate(variable);
         // set status flag
         void set_valid(bool);
         // get status flag
@@ -65,7 +70,7 @@ namespace sol {
         // give the number of assigned variables
         std::size_t size() const;
         // provide variable assignments
-        const std::map<variable, bool>& map() const;
+        const cnf::assignment& assignment() const;
         // give maximum variable key
         variable get_max_var() const;
         // give number of clauses
@@ -83,7 +88,9 @@ namespace sol {
 
     private:
         // tracks variable assignments
-        std::map<variable, bool> variables;
+        cnf::assignment variables;
+        // number of assigned variables
+        std::size_t num_assigned;
         // store statistics
         std::map<std::string, std::string> statistics;
         // largest variable
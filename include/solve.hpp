@@ -8,9 +8,11 @@
 
 #include <boost/program_options.hpp>
 #include <string>
+#include <vector>
 #include <chrono>
 #include <cstdint>
 #include <istream>
+#include <sstream>
 #include <ostream>
 #include <thread>
 #include <format>
@@ -18,6 +20,7 @@
 #include <iostream>
 #include <csignal>
 #include <fstream>
+#include <filesystem>
 #include "sol.hpp"
 #include "cnf.hpp"
 #include "message.hpp"
@@ -31,6 +34,19 @@ namespace solver {
         LocalSearch = 3,
         CDCL = 4
     };
+
+    enum Heuristic: ushort {
+        VSIDS = 0,
+        VMTF = 1,
+        Order = 2
+    };
+
+    enum Restarts: ushort {
+        Glucose = 0,
+        Luby = 1,
+        Geometric = 2,
+        Never = 3
+    };
     
 }
 
@@ -68,7 +84,14 @@ namespace solve {
         uint threads;
         std::chrono::duration<int64_t> duration;
         long int memory;
-        std::fstream pstr;
+        std::string problem_path;
+        cnf::Encoding encoding;
+        std::string cache_dir;
+        bool preprocess;
+        std::chrono::milliseconds preprocess_time;
+        bool symmetry;
+        solver::Heuristic heuristic;
+        std::vector<solver::Restarts> restarts;
 
         // Boost program options
         opts::options_description desc;
@@ -78,6 +101,7 @@ namespace solve {
 
     // solve the problem
     int run_portfolio(const program_interface&, std::istream&, std::ostream&);
+    int run_portfolio(const program_interface&, const std::string&, std::ostream&);
 
 
 
@@ -12,22 +12,27 @@
 #include <algorithm>
 #include <thread>
 #include <vector>
+#include <memory>
 #include "cnf.hpp"
 #include "sol.hpp"
 #include "orchestrator.hpp"
+#include "propagator.hpp"
+#include "analyzer.hpp"
+#include "brancher.hpp"
+#include "clause_db.hpp"
+#include "restarter.hpp"
+#include "phaser.hpp"
 
 namespace solver {
 
-    using problem = std::pair<cnf::cnf_expr, sol::solution>;
-
     // ProblemType enum
     using ProblemType = sol::ProblemType;
 
     // a boolean variable; strictly positive
     using variable = int;
 
-     // a disjunctive clause; strictly positive
-    using clause = int;
+    // a disjunctive clause; refers to the clause's offset in the arena
+    using clause = cnf::clause;
 
     // a boolean literal; negative values indicate negation
     // is never zero
@@ -78,10 +83,17 @@ namespace solver {
         void operator()(std::stop_token);
         // divide the problem
         std::vector<dpll> divide(uint);
-        // recurse
-        sol::solution sub_dpll(problem, std::stop_token&);
+        // search for a solution
+        bool search(propagator&, brancher&, phaser&, std::stop_token&);
         // destructor
         ~dpll() {};
+    private:
+        // number of decisions made
+        std::uint64_t decisions;
+        // the clauses as given, which the phaser walks; the expression is
+        // simplified during search, so one copy is shared by the divided
+        // solvers
+        std::shared_ptr<const cnf::cnf_expr> clauses;
     };
 
     class cdcl : public basic_solver {
@@ -92,8 +104,13 @@ namespace solver {
         void operator()(std::stop_token);
         // divide the problem
         std::vector<cdcl> divide(uint);
+        // choose the restart policy
+        void set_restarts(Restarts);
         // destructor
         ~cdcl() {};
+    private:
+        // the restart policy
+        Restarts restarts;
     };
 
     class local_search : public basic_solver {
@@ -102,6 +119,10 @@ namespace solver {
         local_search(const cnf::cnf_expr&, solve::orchestrator&);
         // run the algorithm
         void operator()(std::stop_token);
+        // make up to the given number of WalkSAT flips, or fewer if a stop
+        // is requested, starting from an assignment and replacing it with
+        // the best one met; returns whether that satisfies every clause
+        static bool walk(const cnf::cnf_expr&, cnf::assignment&, std::uint64_t, std::mt19937_64&, std::stop_token = {});
         // destructor
         ~local_search() {};
     private:
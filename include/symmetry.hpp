@@ -0,0 +1,150 @@
+// symmetry.hpp
+// Logan Moonie
+// Oct 17, 2026
+
+#ifndef INC_SYMMETRY
+#define INC_SYMMETRY
+
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "cnf.hpp"
+
+// a collection of types used to break the symmetries of problems
+namespace symmetry {
+
+    using cnf::variable;
+    using cnf::literal;
+
+    // adds clauses ruling out all but one of each set of symmetric solutions
+    //
+    // The expression is read as a coloured graph: a vertex for each
+    // literal, joined to the vertex of its negation, and a vertex of
+    // another colour for each clause, joined to the vertices of its
+    // literals. A permutation of the vertices that keeps every edge, an
+    // automorphism, maps literals to literals and clauses to clauses, so
+    // it maps every solution to another solution.
+    //
+    // Generators of the automorphism group are found by partition
+    // refinement. The vertices are split into cells until every vertex
+    // of a cell has the same number of neighbours in each other cell.
+    // Vertices are then individualized, one at a time, down a first path
+    // until every cell holds one vertex. Going back up the path, each
+    // other vertex of the cell split at each level is individualized in
+    // its place, and the search descends again to a second discrete
+    // partition. Matching the two cell by cell gives a permutation, which
+    // is kept if it is an automorphism. Vertices already known to share
+    // an orbit are skipped, and each descent has a bounded number of
+    // nodes, so some generators may be missed.
+    //
+    // For each generator g, a lex-leader predicate requires that a
+    // solution, read in order of its variables, is no greater than the
+    // solution given by g. Every set of symmetric solutions has a least
+    // member, so no set is lost. Only the first few variables moved by g
+    // are compared, and the predicate is written out as clauses over the
+    // variables themselves, so no variables are added.
+    class breaker {
+    public:
+        // no default constructor
+        breaker() = delete;
+        // time limit constructor
+        breaker(std::chrono::steady_clock::duration);
+        // no copying
+        breaker(const breaker&) = delete;
+        breaker& operator=(const breaker&) = delete;
+        // find the symmetries of an expression and add clauses breaking them
+        void operator()(cnf::cnf_expr&);
+        // add the work done to a set of statistics
+        void report(std::map<std::string, std::string>&) const;
+        // give the number of generators found
+        std::size_t num_generators() const;
+        // give the number of clauses added
+        std::size_t num_added_clauses() const;
+    private:
+        // the variable of each pair of literal vertices; the positive
+        // literal of the i-th is vertex 2i, and its negation 2i + 1
+        std::vector<variable> vars;
+        // the number of literal vertices; clause vertices follow them
+        std::uint32_t num_literals;
+        // the neighbours of each vertex, in one list with an offset per vertex
+        std::vector<std::uint32_t> offsets;
+        std::vector<std::uint32_t> edges;
+        // the vertices in cell order, and the position of each
+        std::vector<std::uint32_t> lab;
+        std::vector<std::uint32_t> inv;
+        // the first position of the cell of each vertex
+        std::vector<std::uint32_t> cell;
+        // the end of each cell, indexed by its first position
+        std::vector<std::uint32_t> cell_end;
+        // the number of cells
+        std::uint32_t num_cells;
+        // splits made, each as the first position of the new cell and of
+        // the cell it was split from, so they can be undone in reverse
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> splits;
+        // cells waiting to be used as splitters, and whether each is waiting
+        std::vector<std::uint32_t> queue;
+        std::vector<bool> queued;
+        // scratch space for refinement
+        std::vector<std::uint32_t> counts;
+        std::vector<std::uint32_t> touched;
+        // the first path: the vertex individualized, the first position
+        // of its cell, the number of splits before it, and the trace of
+        // the refinement after it, at each level
+        std::vector<std::uint32_t> path_vertex;
+        std::vector<std::uint32_t> path_cell;
+        std::vector<std::size_t> path_mark;
+        std::vector<std::uint64_t> path_trace;
+        // the vertices of the discrete partition at the end of the first path
+        std::vector<std::uint32_t> first_leaf;
+        // the permutation found at the last leaf reached
+        std::vector<std::uint32_t> perm;
+        // the orbits of the generators found, as a union-find forest
+        std::vector<std::uint32_t> orbits;
+        // the generators, each as the image of the positive literal of
+        // every variable it moves, in order of the variables
+        std::vector<std::vector<std::pair<variable, literal>>> generators;
+        // the time allowed, and when it runs out
+        std::chrono::steady_clock::duration limit;
+        std::chrono::steady_clock::time_point deadline;
+        // number of limit checks made, so the clock is read only sometimes
+        std::size_t checks;
+        // whether the time ran out
+        bool timed_out;
+        // whether an expression was searched
+        bool ran;
+        // work done
+        std::size_t num_clauses;
+        double seconds;
+        // build the graph of an expression
+        void build(const cnf::cnf_expr&);
+        // check whether the time limit was reached
+        bool out_of_time();
+        // split the cells until the partition is equitable; gives a trace
+        // of the splits made
+        std::uint64_t refine();
+        // split a vertex from its cell
+        void individualize(std::uint32_t);
+        // undo every split made after the given number of splits
+        void undo(std::size_t);
+        // give the first cell holding more than one vertex, searching
+        // from a position
+        std::uint32_t target_cell(std::uint32_t) const;
+        // search below a level for a leaf matching the first
+        bool descend(std::size_t, std::size_t&);
+        // check whether the permutation is an automorphism
+        bool is_automorphism() const;
+        // keep the permutation as a generator
+        void record();
+        // find the orbit of a vertex
+        std::uint32_t orbit(std::uint32_t);
+        // search for generators
+        void search();
+        // add a lex-leader predicate for each generator
+        void add_predicates(cnf::cnf_expr&);
+    };
+
+}
+
+#endif
@@ -37,7 +37,7 @@ namespace verify {
         bool quiet;
         bool print_help;
         bool print_formats;
-        std::fstream pstr;
+        std::string problem_path;
         std::fstream sstr;
 
         // Boost program options
@@ -0,0 +1,207 @@
+// binary.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "cnf.hpp"
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+// a collection of functions used to store parsed problems in binary form
+//
+// A binary problem is a fixed header followed by three arrays of 32-bit
+// words: a bitmap of the variables present in the problem, the clause
+// arena, and the definitions of introduced variables. The arena is laid
+// out exactly as in cnf_expr, so it is loaded with a single copy out of
+// a memory mapped file. The header records a format version and a
+// checksum of everything after it.
+namespace cnf::io {
+
+    // marks the start of a binary problem; the leading byte cannot begin
+    // a text problem
+    constexpr char binary_magic[8] = {'\x7f', 'S', 'A', 'T', 'B', 'I', 'N', '\n'};
+
+    // changes whenever the layout of binary problems changes
+    constexpr std::uint32_t binary_version = 1;
+
+    // the fixed header of a binary problem
+    struct binary_header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t type;
+        std::int32_t max_var;
+        std::int32_t max_input_var;
+        std::uint64_t num_input_clauses;
+        std::uint64_t num_tautologies;
+        std::uint64_t num_duplicates;
+        std::uint64_t num_clauses;
+        // sizes of the arrays, in words
+        std::uint64_t present_size;
+        std::uint64_t arena_size;
+        std::uint64_t definitions_size;
+        // hash of everything after the header
+        std::uint64_t checksum;
+    };
+    static_assert(sizeof(binary_header) == 88);
+
+    // hash a run of bytes, eight at a time
+    inline std::uint64_t hash_bytes(const char* data, std::size_t size, std::uint64_t hash = 14695981039346656037ull) {
+        std::size_t pos(0);
+        for (; pos + 8 <= size; pos += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, data + pos, 8);
+            hash = (hash ^ word) * 1099511628211ull;
+            hash ^= hash >> 32;
+        }
+        for (; pos < size; pos++) {
+            hash = (hash ^ static_cast<unsigned char>(data[pos])) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // check whether problem text is a binary problem
+    bool is_binary_problem(std::string_view text) {
+        return text.size() >= sizeof(binary_magic) &&
+            std::memcmp(text.data(), binary_magic, sizeof(binary_magic)) == 0;
+    }
+
+    // give the file name under which a problem is cached, from the hash of
+    // its text and the encoding used to read it
+    std::string cache_name(std::string_view text, Encoding encoding) {
+        std::uint64_t hash = hash_bytes(text.data(), text.size());
+        hash = (hash ^ binary_version ^ (encoding == Encoding::Tseitin ? 0x100 : 0)) * 1099511628211ull;
+        return std::format("{:016x}.satbin", hash);
+    }
+
+    // load_binary_problem rebuilds a cnf_expr from a binary problem,
+    // throwing an exception if it is corrupt, truncated, or written by
+    // another version. The expression must be freshly constructed.
+    cnf_expr& load_binary_problem(cnf_expr& expr, std::string_view text) {
+        binary_header header;
+        if (text.size() < sizeof(header)) {
+            throw std::invalid_argument(err::binary_format);
+        }
+        std::memcpy(&header, text.data(), sizeof(header));
+        const std::size_t words = (text.size() - sizeof(header)) / sizeof(literal);
+        if (
+            std::memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0 ||
+            header.version != binary_version ||
+            header.max_var < header.max_input_var ||
+            header.max_input_var <= 0 ||
+            header.present_size != (static_cast<std::uint64_t>(header.max_var) + 32) / 32 ||
+            (text.size() - sizeof(header)) % sizeof(literal) != 0 ||
+            header.present_size + header.arena_size + header.definitions_size != words ||
+            header.arena_size >= no_clause ||
+            hash_bytes(text.data() + sizeof(header), text.size() - sizeof(header)) != header.checksum
+        ) {
+            throw std::invalid_argument(err::binary_format);
+        }
+        const char* data = text.data() + sizeof(header);
+        std::vector<std::uint32_t> present(header.present_size);
+        std::memcpy(present.data(), data, header.present_size * sizeof(literal));
+        data += header.present_size * sizeof(literal);
+        const lit_span arena(reinterpret_cast<const literal*>(data), header.arena_size);
+        data += header.arena_size * sizeof(literal);
+        const lit_span definitions(reinterpret_cast<const literal*>(data), header.definitions_size);
+
+        // the clauses must fill the arena exactly and name known variables
+        std::size_t cl(0);
+        std::size_t clauses(0);
+        while (cl < arena.size()) {
+            if (arena[cl] < 0 || arena.size() - cl < cnf_expr::header_size + static_cast<std::size_t>(arena[cl])) {
+                throw std::invalid_argument(err::binary_format);
+            }
+            for (const literal& lit : arena.subspan(cl + cnf_expr::header_size, arena[cl])) {
+                if (lit == 0 || lit < -header.max_var || lit > header.max_var) {
+                    throw std::invalid_argument(err::binary_format);
+                }
+            }
+            cl += cnf_expr::header_size + arena[cl];
+            clauses++;
+        }
+        if (clauses != header.num_clauses) {
+            throw std::invalid_argument(err::binary_format);
+        }
+        // each definition must fit and define an introduced variable
+        for (std::size_t pos(0); pos < definitions.size(); pos += 3 + definitions[pos + 2]) {
+            if (
+                definitions.size() - pos < 3 ||
+                definitions[pos] <= header.max_input_var ||
+                definitions[pos] > header.max_var ||
+                definitions[pos + 2] < 0 ||
+                definitions.size() - pos - 3 < static_cast<std::size_t>(definitions[pos + 2])
+            ) {
+                throw std::invalid_argument(err::binary_format);
+            }
+        }
+
+        expr.type = static_cast<ProblemType>(header.type != 0);
+        expr.max_var = header.max_var;
+        expr.max_input_var = header.max_input_var;
+        expr.num_input_clauses = header.num_input_clauses;
+        expr.num_removed_tautologies = header.num_tautologies;
+        expr.num_removed_duplicates = header.num_duplicates;
+        expr.reserve_variable(expr.max_var);
+        for (variable var(1); var <= expr.max_var; var++) {
+            if (present[var / 32] >> (var % 32) & 1) {
+                expr.add_variable(var);
+            }
+        }
+        expr.clauses.reserve(header.num_clauses);
+        expr.append_block(arena);
+        expr.definitions.assign(definitions.begin(), definitions.end());
+        expr.index_occurrences();
+        expr.shrink_to_fit();
+        return expr;
+    }
+
+    // write_binary_problem stores the active clauses of a cnf_expr as a
+    // binary problem at the given path. The file is written under a
+    // temporary name and then renamed, so readers never see it partly
+    // written. It returns false if the file could not be written.
+    bool write_binary_problem(const cnf_expr& expr, const std::string& path) {
+        std::vector<literal> words((static_cast<std::size_t>(expr.max_var) + 32) / 32, 0);
+        for (variable var(1); var <= expr.max_var && static_cast<std::size_t>(var) < expr.present.size(); var++) {
+            if (expr.present[var]) {
+                words[var / 32] |= 1u << (var % 32);
+            }
+        }
+        const std::size_t present_size = words.size();
+        for (const clause& cl : expr.clauses) {
+            const lit_span lits = expr.get_clause(cl);
+            words.push_back(lits.size());
+            words.insert(words.end(), cnf_expr::header_size - 1, 0);
+            words.insert(words.end(), lits.begin(), lits.end());
+        }
+        const std::size_t arena_size = words.size() - present_size;
+        words.insert(words.end(), expr.definitions.begin(), expr.definitions.end());
+
+        binary_header header;
+        std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+        header.version = binary_version;
+        header.type = expr.type;
+        header.max_var = expr.max_var;
+        header.max_input_var = expr.max_input_var;
+        header.num_input_clauses = expr.num_input_clauses;
+        header.num_tautologies = expr.num_removed_tautologies;
+        header.num_duplicates = expr.num_removed_duplicates;
+        header.num_clauses = expr.clauses.size();
+        header.present_size = present_size;
+        header.arena_size = arena_size;
+        header.definitions_size = expr.definitions.size();
+        header.checksum = hash_bytes(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(literal));
+
+        const std::string temp = std::format("{}.{}.tmp", path, ::getpid());
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(literal));
+        file.close();
+        if (!file || std::rename(temp.c_str(), path.c_str()) != 0) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+}
@@ -3,7 +3,20 @@
 // Jul 12, 2024
 
 #include "cnf.hpp"
+#include "formula.hpp"
+#include "compressed.hpp"
 #include <limits>
+#include <algorithm>
+#include <numeric>
+#include <climits>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <thread>
+#include <exception>
 
 namespace cnf {
 
@@ -13,126 +26,414 @@ namespace cnf {
     // a boolean variable; strictly positive
     using variable = int;
 
+    // default constructor
+    cnf_expr::cnf_expr():
+        num_present(0),
+        num_empty(0),
+        num_input_clauses(0),
+        num_removed_tautologies(0),
+        num_removed_duplicates(0),
+        max_var(0),
+        max_input_var(0),
+        type(ProblemType::CNF)
+    {}
+
     // input stream constructor
-    cnf_expr::cnf_expr(std::istream& istr) {
+    cnf_expr::cnf_expr(std::istream& istr): cnf_expr() {
         io::extract_cnf_problem(*this, istr);
     }
 
-    // add a literal to a clause
-    void cnf_expr::add_literal(literal lit, clause cl) {
-        if (!literals.contains(abs(lit))) {
-            literals.insert({abs(lit), cl_set()});
-            literals.insert({-abs(lit), cl_set()});
+    // problem text constructor
+    cnf_expr::cnf_expr(std::string_view text): cnf_expr() {
+        io::extract_cnf_problem(*this, text);
+    }
+
+    // make room for the given variable
+    void cnf_expr::reserve_variable(variable var) {
+        if (present.size() <= static_cast<std::size_t>(var)) {
+            present.resize(var + 1, false);
+            literals.resize(2 * (static_cast<std::size_t>(var) + 1));
+            counts.resize(2 * (static_cast<std::size_t>(var) + 1), 0);
+            pure_queued.resize(2 * (static_cast<std::size_t>(var) + 1), false);
+        }
+    }
+
+    // release unused capacity once the expression is built
+    void cnf_expr::shrink_to_fit() {
+        arena.shrink_to_fit();
+        clauses.shrink_to_fit();
+    }
+
+    // sort the clauses of a freshly parsed expression and remove
+    // tautologies and duplicates
+    // Literals are sorted by lit_index, so a literal and its negation end
+    // up adjacent. Kept clauses are moved down over removed ones in a
+    // single pass, and found again by the hash of their sorted literals.
+    void cnf_expr::normalize() {
+        num_input_clauses = clauses.size();
+        // kept clauses by hash, in an open-addressed table
+        std::size_t table_size(1);
+        while (table_size < 2 * clauses.size()) table_size *= 2;
+        std::vector<clause> table(table_size, no_clause);
+        const std::size_t mask = table_size - 1;
+        auto by_index = [](literal a, literal b) {
+            return lit_index(a) < lit_index(b);
+        };
+        std::size_t write(0);
+        std::size_t kept(0);
+        unit_queue.clear();
+        for (const clause& cl : clauses) {
+            const std::size_t size = arena[cl];
+            literal* first = &arena[cl + header_size];
+            std::sort(first, first + size, by_index);
+            // a tautology holds a literal next to its negation
+            bool tautology(false);
+            for (std::size_t i(1); i < size && !tautology; i++) {
+                tautology = lit_index(first[i]) == (lit_index(first[i - 1]) ^ 1);
+            }
+            std::uint64_t hash(14695981039346656037ull);
+            for (std::size_t i(0); i < size; i++) {
+                hash = (hash ^ static_cast<std::uint32_t>(first[i])) * 1099511628211ull;
+            }
+            std::size_t slot = (hash ^ (hash >> 29)) & mask;
+            bool duplicate(false);
+            if (!tautology) {
+                for (; table[slot] != no_clause; slot = (slot + 1) & mask) {
+                    if (std::ranges::equal(get_clause(table[slot]), lit_span(first, size))) {
+                        duplicate = true;
+                        break;
+                    }
+                }
+            }
+            if (tautology || duplicate) {
+                for (std::size_t i(0); i < size; i++) {
+                    discount_literal(first[i]);
+                }
+                if (size == 0) {
+                    num_empty--;
+                }
+                num_removed_tautologies += tautology;
+                num_removed_duplicates += duplicate;
+                continue;
+            }
+            // move the clause down over those removed before it
+            if (write != cl) {
+                std::copy(arena.begin() + cl, arena.begin() + cl + header_size + size, arena.begin() + write);
+            }
+            arena[write + 1] = kept;
+            arena[write + 2] = 0;
+            if (size == 1) {
+                queue_unit(write);
+            }
+            table[slot] = write;
+            clauses[kept++] = write;
+            write += header_size + size;
+        }
+        arena.resize(write);
+        clauses.resize(kept);
+    }
+
+    // build every occurrence list at its exact size
+    void cnf_expr::index_occurrences() {
+        for (std::size_t idx(0); idx < literals.size(); idx++) {
+            literals[idx].clear();
+            literals[idx].reserve(counts[idx]);
+        }
+        for (const clause& cl : clauses) {
+            for (const literal& lit : get_clause(cl)) {
+                literals[lit_index(lit)].push_back(cl);
+            }
+        }
+    }
+
+    // queue a clause that may have become unit
+    inline void cnf_expr::queue_unit(clause cl) {
+        if (arena[cl + 2] == 0) {
+            arena[cl + 2] = 1;
+            unit_queue.push_back(cl);
+        }
+    }
+
+    // queue a literal that may have become pure
+    inline void cnf_expr::queue_pure(literal lit) {
+        if (!pure_queued[lit_index(lit)]) {
+            pure_queued[lit_index(lit)] = true;
+            pure_queue.push_back(lit);
         }
-        literals[lit].insert(cl);
-        if (!clauses.contains(cl)) {
-            clauses.insert({cl, lit_set()});
+    }
+
+    // count an active occurrence of a literal
+    inline void cnf_expr::count_literal(literal lit) {
+        if (counts[lit_index(lit)]++ == 0 && counts[lit_index(-lit)] == 0) {
+            queue_pure(lit);
+        }
+    }
+
+    // discount an active occurrence of a literal
+    inline void cnf_expr::discount_literal(literal lit) {
+        if (--counts[lit_index(lit)] == 0 && counts[lit_index(-lit)] > 0) {
+            queue_pure(-lit);
+        }
+    }
+
+    // add a clause
+    clause cnf_expr::add_clause(lit_span lits) {
+        clause cl = open_clause();
+        for (const literal& lit : lits) {
+            append_literal(cl, lit);
+        }
+        close_clause(cl);
+        for (const literal& lit : get_clause(cl)) {
+            literals[lit_index(lit)].push_back(cl);
+        }
+        return cl;
+    }
+
+    // begin a clause at the end of the arena
+    clause cnf_expr::open_clause() {
+        if (arena.size() + header_size >= no_clause) {
+            throw std::length_error(err::expression_size);
+        }
+        clause cl = arena.size();
+        arena.push_back(0);
+        arena.push_back(clauses.size());
+        arena.push_back(0);
+        return cl;
+    }
+
+    // add a literal to the open clause
+    void cnf_expr::append_literal(clause cl, literal lit) {
+        // duplicate literals are merged
+        if (std::find(arena.begin() + cl + header_size, arena.end(), lit) != arena.end()) {
+            return;
+        }
+        if (arena.size() + 1 >= no_clause) {
+            throw std::length_error(err::expression_size);
+        }
+        add_variable(abs(lit));
+        arena.push_back(lit);
+        count_literal(lit);
+    }
+
+    // finish the open clause, making it active
+    // its occurrences are recorded by the caller
+    void cnf_expr::close_clause(clause cl) {
+        arena[cl] = arena.size() - cl - header_size;
+        if (arena[cl] == 0) {
+            num_empty++;
+        } else if (arena[cl] == 1) {
+            queue_unit(cl);
+        }
+        clauses.push_back(cl);
+    }
+
+    // record a variable as appearing in the expression
+    void cnf_expr::add_variable(variable var) {
+        reserve_variable(var);
+        if (!present[var]) {
+            present[var] = true;
+            num_present++;
+        }
+    }
+
+    // introduce a variable beyond those named by the problem
+    variable cnf_expr::new_variable() {
+        if (max_var == std::numeric_limits<variable>::max()) {
+            throw std::length_error(err::expression_size);
+        }
+        add_variable(++max_var);
+        return max_var;
+    }
+
+    // define an introduced variable as the conjunction or disjunction
+    // of the given literals, which must not be defined after it
+    void cnf_expr::define_variable(variable var, bool conjunction, lit_span lits) {
+        definitions.push_back(var);
+        definitions.push_back(conjunction);
+        definitions.push_back(lits.size());
+        definitions.insert(definitions.end(), lits.begin(), lits.end());
+    }
+
+    // give values to introduced variables from their definitions
+    // definitions are visited in order, so each is evaluated after the
+    // variables it depends on
+    void cnf_expr::extend(assignment& assigns) const {
+        std::size_t pos(0);
+        while (pos < definitions.size()) {
+            const variable var = definitions[pos];
+            const bool conjunction = definitions[pos + 1];
+            const lit_span lits(&definitions[pos + 3], definitions[pos + 2]);
+            bool value(conjunction);
+            for (const literal& lit : lits) {
+                if (assigns.is_true(lit) != conjunction) {
+                    value = !conjunction;
+                    break;
+                }
+            }
+            assigns.assign(value ? var : -var);
+            pos += 3 + lits.size();
         }
-        clauses[cl].insert(lit);
     }
 
     // remove a literal from a clause
     void cnf_expr::remove_literal(literal lit, clause cl) {
-        literals[lit].erase(cl);
-        clauses[cl].erase(lit);
+        // swap the literal past the end of the active region
+        literal* first = &arena[cl + header_size];
+        literal* last = first + arena[cl] - 1;
+        *std::find(first, last, lit) = *last;
+        *last = lit;
+        if (--arena[cl] == 0) {
+            num_empty++;
+        } else if (arena[cl] == 1) {
+            queue_unit(cl);
+        }
+        discount_literal(lit);
+        undo_log.push_back({cl, lit});
     }
 
     // remove a redundant variable from the record
     void cnf_expr::remove_variable(variable var) {
-        literals.erase(var);
-        literals.erase(-var);
+        if (static_cast<std::size_t>(var) < present.size() && present[var]) {
+            present[var] = false;
+            num_present--;
+        }
     }
 
     // remove an entire clause
     void cnf_expr::remove_clause(clause cl) {
-        for (const literal& lit : clauses[cl]) {
-            literals[lit].erase(cl);
+        for (const literal& lit : get_clause(cl)) {
+            discount_literal(lit);
+        }
+        if (arena[cl] == 0) {
+            num_empty--;
+        }
+        // move the last active clause into the vacated position
+        clause moved = clauses.back();
+        clauses[arena[cl + 1]] = moved;
+        arena[moved + 1] = arena[cl + 1];
+        clauses.pop_back();
+        arena[cl + 1] = removed;
+        undo_log.push_back({cl, 0});
+    }
+
+    // remove every clause, keeping the record of variables
+    // nothing removed before this can be undone
+    void cnf_expr::clear_clauses() {
+        arena.clear();
+        clauses.clear();
+        for (cl_list& occurs : literals) {
+            cl_list().swap(occurs);
         }
-        clauses.erase(cl);
+        std::fill(counts.begin(), counts.end(), 0);
+        unit_queue.clear();
+        pure_queue.clear();
+        std::fill(pure_queued.begin(), pure_queued.end(), false);
+        undo_log.clear();
+        num_empty = 0;
     }
 
     // assign a variable and simplify the expression
     void cnf_expr::assign_and_simplify(variable var, bool val) {
-        // keep a record of what to remove
-        cl_set clauses_to_delete;
-        std::unordered_multimap<literal, clause> literals_to_delete;
-
-        // for each clause in which the negative literal appears
-        for (auto const& cl : literals.at(-var)) {
-            if (!val) {
-                // literal is true; can delete the clause
-                clauses_to_delete.insert(cl);
-            } else {
-                // literal is false; can remove literal from clause
-                literals_to_delete.insert({-var, cl});
+        literal true_lit = val ? var : -var;
+        // the literal is true; can delete the clause
+        for (const clause& cl : literals.at(lit_index(true_lit))) {
+            if (arena[cl + 1] != removed) {
+                remove_clause(cl);
             }
         }
-        // for each clause in which the positive literal appears
-        for (auto const& cl : literals.at(var)) {
-            if (val) {
-                // literal is true; can delete the clause
-                clauses_to_delete.insert(cl);
-            } else {
-                // literal is false; can remove literal from clause
-                literals_to_delete.insert({var, cl});
+        // the literal is false; can remove literal from clause
+        for (const clause& cl : literals.at(lit_index(-true_lit))) {
+            if (arena[cl + 1] != removed) {
+                remove_literal(-true_lit, cl);
             }
         }
+    }
 
-        
-        // delete the clauses and literals
-        // this is delayed to prevent use-after-free errors
-        for (auto const& [lit, cl] : literals_to_delete) {
-            remove_literal(lit, cl);
-        }
-        for (auto const& cl : clauses_to_delete) {
-            remove_clause(cl);
-        }
+    // give a mark to which later removals can be undone
+    std::size_t cnf_expr::checkpoint() const {
+        return undo_log.size();
     }
 
-    // return an iterator to a unit clause
-    std::unordered_map<clause, lit_set>::const_iterator cnf_expr::unit_clause() const {
-        auto iter(clauses.begin());
-        while (iter != clauses.end()) {
-            if (iter->second.size() == 1) {
-                return iter;
+    // undo every removal made since the given mark
+    void cnf_expr::undo(std::size_t mark) {
+        while (undo_log.size() > mark) {
+            const auto [cl, lit] = undo_log.back();
+            undo_log.pop_back();
+            if (lit == 0) {
+                // restore a removed clause
+                arena[cl + 1] = clauses.size();
+                clauses.push_back(cl);
+                for (const literal& cl_lit : get_clause(cl)) {
+                    count_literal(cl_lit);
+                }
+                if (arena[cl] == 0) {
+                    num_empty++;
+                } else if (arena[cl] == 1) {
+                    queue_unit(cl);
+                }
+            } else {
+                // restore a removed literal; it sits just past the active region
+                if (arena[cl]++ == 0) {
+                    num_empty--;
+                    queue_unit(cl);
+                }
+                count_literal(lit);
             }
-            if (iter->second.empty()) {
-                return clauses.end();
+        }
+    }
+
+    // return a unit clause
+    clause cnf_expr::unit_clause() {
+        if (num_empty > 0) {
+            return no_clause;
+        }
+        while (!unit_queue.empty()) {
+            clause cl = unit_queue.back();
+            unit_queue.pop_back();
+            arena[cl + 2] = 0;
+            if (arena[cl + 1] != removed && arena[cl] == 1) {
+                return cl;
             }
-            iter++;
         }
-        return iter;
+        return no_clause;
     }
 
     // return a pure literal
-    literal cnf_expr::pure_literal() const {
-        for (auto const& var : variables()) {
-            if (!literals.at(var).empty() && literals.at(-var).empty()) {
-                return var;
-            }
-            if (!literals.at(-var).empty() && literals.at(var).empty()) {
-                return -var;
+    literal cnf_expr::pure_literal() {
+        while (!pure_queue.empty()) {
+            literal lit = pure_queue.back();
+            pure_queue.pop_back();
+            pure_queued[lit_index(lit)] = false;
+            if (counts[lit_index(lit)] > 0 && counts[lit_index(-lit)] == 0) {
+                return lit;
             }
         }
         return 0;
     }
 
-    // end iterators for the maps
-    std::unordered_map<literal, cl_set>::const_iterator cnf_expr::literals_end() const {
-        return literals.end();
-    }
-    std::unordered_map<clause, lit_set>::const_iterator cnf_expr::clauses_end() const {
-        return clauses.end();
-    }
-
     // give the number of active clauses
     std::size_t cnf_expr::get_num_clauses() const {
         return clauses.size();
     }
 
+    // give the number of clauses in the problem as it was read
+    std::size_t cnf_expr::get_num_input_clauses() const {
+        return num_input_clauses;
+    }
+
+    // give the number of tautologies removed while reading the problem
+    std::size_t cnf_expr::num_tautologies() const {
+        return num_removed_tautologies;
+    }
+
+    // give the number of duplicate clauses removed while reading the problem
+    std::size_t cnf_expr::num_duplicates() const {
+        return num_removed_duplicates;
+    }
+
     // give the number of active variables
     std::size_t cnf_expr::num_variables() const {
-        return literals.size()/2;
+        return num_present;
     }
 
     // give the maximum variable key
@@ -140,20 +441,31 @@ namespace cnf {
         return max_var;
     }
 
+    // give the maximum variable named by the problem
+    variable cnf_expr::get_max_input_var() const {
+        return max_input_var;
+    }
+
     // evaluate the expression
-    bool cnf_expr::eval(const std::map<variable, bool>& assigns) const {
-        for (auto const& [key, cl]: clauses) {
+    // throws if a clause's literals are all false or unassigned and any of
+    // them is unassigned
+    bool cnf_expr::eval(const assignment& assigns) const {
+        for (const clause& cl : clauses) {
             bool clause_is_true(false);
-            for (auto const& lit : cl) {
-                if (
-                    lit > 0 && assigns.at(abs(lit)) ||
-                    lit < 0 && !assigns.at(abs(lit))
-                ) {
+            for (const literal& lit : get_clause(cl)) {
+                if (assigns.is_true(lit)) {
                     clause_is_true = true;
                     break;
                 }
             }
-            if (!clause_is_true) return false;
+            if (!clause_is_true) {
+                for (const literal& lit : get_clause(cl)) {
+                    if (!assigns.is_assigned(abs(lit))) {
+                        throw std::out_of_range(err::invalid_variable);
+                    }
+                }
+                return false;
+            }
         }
         return true;
     }
@@ -161,60 +473,66 @@ namespace cnf {
     // return a set of the expression's variables
     std::set<variable> cnf_expr::variables() const {
         std::set<variable> var_set;
-        for (auto const& [lit, cl] : literals) {
-            if (lit > 0) {
-                var_set.insert(lit);
+        for (variable var(1); static_cast<std::size_t>(var) < present.size(); var++) {
+            if (present[var]) {
+                var_set.insert(var_set.end(), var);
             }
         }
         return var_set;
     }
 
-    // return a set of unsatisfied clauses
-    std::set<clause> cnf_expr::unsatisfied_clauses(
-        const std::map<variable, bool>& assigns
-    ) const {
-        std::set<clause> unsat_clauses;
-        for (auto const& [key, cl]: clauses) {
+    // return a list of unsatisfied clauses
+    cl_list cnf_expr::unsatisfied_clauses(const assignment& assigns) const {
+        cl_list unsat_clauses;
+        for (const clause& cl : clauses) {
             bool clause_is_true(false);
-            for (auto const& lit : cl) {
-                if (
-                    lit > 0 && assigns.at(abs(lit)) ||
-                    lit < 0 && !assigns.at(abs(lit))
-                ) {
+            for (const literal& lit : get_clause(cl)) {
+                if (assigns.is_true(lit)) {
                     clause_is_true = true;
                     break;
                 }
             }
             if (!clause_is_true) {
-                unsat_clauses.insert(key);
-            };
+                unsat_clauses.push_back(cl);
+            }
         }
         return unsat_clauses;
     }
 
     // check for empty clauses
     bool cnf_expr::empty_clause() const {
-        for (auto const& [cl, lset] : clauses) {
-            if (lset.empty()) {
-                return true;
-            }
-        }
-        return false;
+        return num_empty > 0;
     }
 
     // return an active variable
     variable cnf_expr::pick_var() const {
-        return abs(*(clauses.begin()->second.begin()));
+        for (const clause& cl : clauses) {
+            if (arena[cl] > 0) {
+                return abs(arena[cl + header_size]);
+            }
+        }
+        return 0;
+    }
+
+    // check whether a variable appears in an active clause
+    bool cnf_expr::is_active(variable var) const {
+        if (static_cast<std::size_t>(var) >= present.size()) return false;
+        return counts[lit_index(var)] > 0 || counts[lit_index(-var)] > 0;
+    }
+
+    // return the active literals of the requested clause
+    lit_span cnf_expr::get_clause(clause cl) const {
+        return lit_span(&arena[cl + header_size], arena[cl]);
     }
 
-    // return a reference to the requested clause
-    const lit_set& cnf_expr::get_clause(clause cl) const {
-        return clauses.at(cl);
+    // return the clause list of the requested literal
+    const cl_list& cnf_expr::get_literal(literal lit) const {
+        return literals.at(lit_index(lit));
     }
 
-    // return a reference to the clause list of the requested literal
-    const cl_set& cnf_expr::get_literal(literal lit) const {
-        return literals.at(lit);
+    // return the list of active clauses
+    const cl_list& cnf_expr::get_clauses() const {
+        return clauses;
     }
 
     // get the problem type
@@ -224,462 +542,143 @@ namespace cnf {
 
     // find an empty clause, presuming there is one
     clause cnf_expr::get_empty_clause() const {
-        for (auto const& [cl, lset] : clauses) {
-            if (lset.empty()) {
+        if (num_empty == 0) {
+            return no_clause;
+        }
+        for (const clause& cl : clauses) {
+            if (arena[cl] == 0) {
                 return cl;
             }
         }
-        return 0;
+        return no_clause;
     }
 
-    // find highest-numbered clause
-    clause cnf_expr::get_max_clause() const {
-        clause max_clause = 0;
-        for (auto const& [cl, lset] : clauses) {
-            if (cl > max_clause) {
-                max_clause = cl;
-            }
+    // give the number of bytes used to store the expression
+    std::size_t cnf_expr::memory_usage() const {
+        std::size_t bytes =
+            arena.capacity() * sizeof(literal) +
+            clauses.capacity() * sizeof(clause) +
+            literals.capacity() * sizeof(cl_list) +
+            counts.capacity() * sizeof(std::uint32_t) +
+            present.capacity() / CHAR_BIT +
+            pure_queued.capacity() / CHAR_BIT;
+        for (const cl_list& occurs : literals) {
+            bytes += occurs.capacity() * sizeof(clause);
         }
-        return max_clause;
+        return bytes;
     }
 
-    // used to print cnf_expr
-    std::ostream& operator<<(std::ostream& ostr, const cnf_expr& expr) {
-        auto clause_iter(expr.clauses.begin());
-        while (clause_iter != expr.clauses.end()) {
-            ostr << "{ ";
-            for (literal lit : clause_iter->second) {
-                ostr << lit << " ";
-            }
-            ostr << "}" << std::endl;
-            clause_iter++;
-        }
-        return ostr;
-    }
-}
+    // parts with fewer clauses than this are grouped together, since
+    // solving each alone costs more than it saves
+    constexpr std::size_t min_component_clauses = 64;
 
-// a collection of functions to convert SAT formatted input to CNF
-namespace cnf::sat {
-
-    // Remove extra whitespace, add helpful whitespace, remove extra
-    // parentheses, remove extra formula nesting, etc.
-    bool clean_sat_str(std::string& str) {
-        std::string clean_str;
-        std::size_t i = str.find_first_not_of(" \t\n");
-        std::stack<bool> parenth;
-        int negatives(0);
-        std::stack<bool> in_conjunctive_clause;
-        std::stack<bool> in_disjunctive_clause;
-        in_conjunctive_clause.push(false);
-        in_disjunctive_clause.push(false);
-        while (i != std::string::npos) {
-            if (str.at(i) == '*' || str.at(i) == '+') {
-                if (
-                    str.at(i) == '*' && in_conjunctive_clause.top() ||
-                    str.at(i) == '+' && in_disjunctive_clause.top()
-                ) {
-                    parenth.push(false);
-                } else {
-                    if (negatives % 2 == 1) {
-                        clean_str.push_back('-');
-                        negatives = 0;
-                    }
-                    in_conjunctive_clause.push(str.at(i) == '*');
-                    in_disjunctive_clause.push(str.at(i) == '+');
-                    clean_str.push_back(str.at(i));
-                    parenth.push(true);
-                }
-                i = str.find_first_not_of(" \t\n", i+1);
-                if (str.at(i) == '(') {
-                    if (parenth.top()) clean_str.append("( ");
-                } else {
-                    throw std::invalid_argument(err::expression_format);
-                }
-            } else if (str.at(i) == '(') {
-                parenth.push(false);
-            } else if (str.at(i) == ')') {
-                if (parenth.empty()) {
-                    throw std::invalid_argument(err::expression_format);
-                }
-                if (parenth.top()) {
-                    clean_str.append(") ");
-                    in_conjunctive_clause.pop();
-                    in_disjunctive_clause.pop();
-                }
-                parenth.pop();
-            } else if (str.at(i) == '-') {
-                // check that the negative formula contains a valid formula
-                std::size_t scan_depth(1);
-                bool inner_formula(false);
-                while (!inner_formula) {
-                    std::size_t j(str.find_first_not_of(" \t\n", i+1));
-                    if (j == str.npos) {
-                        throw std::invalid_argument(err::expression_format);
-                    } else if (str.at(j) != '(') break;
-                    j = str.find_first_not_of(" \t\n", j+1);
-                    std::size_t clause_depth(1);
-                    std::size_t max_cl_depth(1);
-                    while (clause_depth > 0 && j < str.size()) {
-                        j = str.find_first_not_of(" \t\n", j+1);
-                        if (str.at(j) == '(') {
-                            clause_depth++;
-                            if (clause_depth > max_cl_depth) {
-                                max_cl_depth = clause_depth;
-                            }
-                        }
-                        if (str.at(j) == ')') clause_depth--;
-                        if (clause_depth == scan_depth) {
-                            if (str.at(j) == '+' ||
-                                str.at(j) == '*'
-                            ) {
-                                if (inner_formula) {
-                                    throw std::invalid_argument(err::expression_format);
-                                } else {
-                                    inner_formula = true;
-                                }
-                            } else if (std::isdigit(str.at(j))) {
-                                if (inner_formula) {
-                                    throw std::invalid_argument(err::expression_format);
-                                } else {
-                                    inner_formula = true;
-                                    while (std::isdigit(str.at(j))) j++;
-                                }
-                            }
-                        }
-                    }
-                    if (scan_depth > max_cl_depth) {
-                        throw std::invalid_argument(err::expression_format);
-                    }
-                    scan_depth++;
-                }
-                negatives++;
-            } else {
-                std::size_t num_len;
-                try {
-                    std::stoi(str.substr(i), &num_len);
-                } catch (...) {
-                    throw std::invalid_argument(err::expression_format);
-                }
-                if (negatives % 2 == 1) {
-                    clean_str.push_back('-');
-                    negatives = 0;
-                }
-                clean_str.append(str.substr(i, num_len));
-                clean_str.push_back(' ');
-                i += num_len - 1;
-            }
-            i = str.find_first_not_of(" \t\n", i+1);
-        }
-        if (!parenth.empty()) throw std::invalid_argument(err::expression_format);
-        if (negatives > 0) throw std::invalid_argument(err::expression_format);
-        // remove clauses containing only one element
-        i = 0;
-        bool string_changed = str != clean_str;
-        str.clear();
-        while (i < clean_str.size()) {
-            if (clean_str.at(i) == '*' || clean_str.at(i) == '+') {
-                std::size_t num_elements(0);
-                std::size_t j(i + 2);
-                std::size_t clause_depth(1);
-                while (clause_depth > 0) {
-                    if (clause_depth == 1) {
-                        if (std::isdigit(clean_str.at(j))) {
-                            num_elements++;
-                            while (std::isdigit(clean_str.at(j))) j++;
-                        } else if (clean_str.at(j) == '(') {
-                            num_elements++;
-                        }
-                    }
-                    if (clean_str.at(j) == '(') clause_depth++;
-                    if (clean_str.at(j) == ')') clause_depth--;
-                    if (num_elements > 1) break;
-                    j++;
-                }
-                if (num_elements > 1) {
-                    str.push_back(clean_str.at(i++));
-                    parenth.push(true);
-                } else if (num_elements == 1) {
-                    i += 3;
-                    parenth.push(false);
-                    continue;
-                } else {
-                    if (clean_str.at(i) == '*') {
-                        str.append(
-                            std::to_string(std::numeric_limits<variable>::max() - 1)
-                        );
-                    } else {
-                        str.append(
-                            std::to_string(std::numeric_limits<variable>::min() + 1)
-                        );
-                    }
-                    i += 4;
-                    string_changed = true;
-                    continue;
-                }
-            } else if (clean_str.at(i) == ')') {
-                if (parenth.top()) {
-                    parenth.pop();
-                } else {
-                    parenth.pop();
-                    i += 2;
-                    continue;
-                }
+    // split the clauses into parts that share no variables
+    // The variables of each clause are joined in a union-find forest, so
+    // each tree is a part. Small parts are packed together until they
+    // reach a useful size. Nothing is given if there would be one part.
+    std::vector<component> cnf_expr::components() const {
+        std::vector<variable> parent(present.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        std::vector<std::uint32_t> size(present.size(), 1);
+        auto find = [&](variable var) {
+            while (parent[var] != var) {
+                parent[var] = parent[parent[var]];
+                var = parent[var];
+            }
+            return var;
+        };
+        for (const clause& cl : clauses) {
+            const lit_span lits = get_clause(cl);
+            if (lits.empty()) {
+                return {};
             }
-            str.push_back(clean_str.at(i));
-            i++;
-        }
-        return string_changed;
-    }
-
-    bool diminish_complement(std::string& str) {
-        // find the first negative sign not part of a literal
-        std::size_t i(0);
-        while (i < str.size()) {
-            if (
-                str.at(i) == '-' &&
-                !std::isdigit(str.at(i + 1))
-            ) break;
-            i++;
-        }
-        // done diminishing complements
-        if (i >= str.size()) return false;
-        // remove complement
-        str.erase(i, 1);
-        // change clause type
-        if (str.at(i) == '*') {
-            str.replace(i, 1, "+");
-            i++;
-        } else if (str.at(i) == '+') {
-            str.replace(i, 1, "*");
-            i++;
-        }
-        // distribute complement
-        i++;
-        std::size_t open_clauses(1);
-        while (open_clauses > 0) {
-            // check for end of clause
-            if (str.at(i) == ')') {
-                open_clauses--;
-            } else if (str.at(i) == '(') {
-                open_clauses++;
-            }
-            if (open_clauses == 1) {
-                if (
-                    str.at(i) == '*' ||
-                    str.at(i) == '+'
-                ) {
-                    str.insert(i, 1, '-');
-                    i++;
-                } else if (str.at(i) == '-') {
-                    str.erase(i, 1);
-                    while (std::isdigit(str.at(i))) i++;
-                } else if (std::isdigit(str.at(i))) {
-                    str.insert(i, 1, '-');
-                    while (std::isdigit(str.at(++i)));
+            variable root = find(abs(lits[0]));
+            for (const literal& lit : lits.subspan(1)) {
+                variable other = find(abs(lit));
+                if (other != root) {
+                    if (size[root] < size[other]) {
+                        std::swap(root, other);
+                    }
+                    parent[other] = root;
+                    size[root] += size[other];
                 }
             }
-            i++;
         }
-        return true;
-    }
 
-    bool distribute(std::string& str) {
-        // find conjunctive clauses containing no nested conjunctive clauses
-        // skip the first level
-        std::size_t con_start(1);
-        while (con_start < str.size()) {
-            if (str.at(con_start) == '*') {
-                std::size_t i(con_start + 2);
-                std::size_t clause_depth(1);
-                while(clause_depth > 0 && clause_depth < 3) {
-                    if (str.at(i) == '(') clause_depth++;
-                    if (str.at(i) == ')') clause_depth--;
-                    i++;
-                }
-                if (clause_depth == 0) break;
-                else con_start = i;
-            }
-            con_start++;
-        }
-        // done distributing; will wrap lone literals in disjunctions
-        if (con_start >= str.size()) {
-            std:size_t i(2);
-            std::size_t clause_depth(1);
-            while(clause_depth > 0) {
-                if (str.at(i) == '(') clause_depth++;
-                if (str.at(i) == ')') clause_depth--;
-                if (clause_depth == 1) {
-                    if (str.at(i) == '-' || std::isdigit(str.at(i))) {
-                        str.insert(i, "+( ");
-                        i += 3;
-                        while (std::isdigit(str.at(++i)));
-                        str.insert(i, " )");
-                        i += 2;
-                    }
-                }
-                i++;
-            }
-            return false;
-        }
-        // find start of parent disjunctive clause
-        std::size_t dis_start(con_start);
-        while (str.at(dis_start) != '+') dis_start--;
-        // look for adjacent literal or conjunction
-        bool val_before(false);
-        bool val_after(false);
-        std::size_t val_start(con_start);
-        while (val_start > dis_start) {
-            // check for literal
-            if (std::isdigit(str.at(val_start))) {
-                val_before = true;
-                do val_start--; while (
-                    std::isdigit(str.at(val_start)) ||
-                    str.at(val_start) == '-'
-                );
-                val_start++;
-                break;
-            }
-            // check for conjunction
-            if (str.at(val_start) == ')') {
-                val_before = true;
-                do val_start--; while (
-                    str.at(val_start) != '*'
-                );
-                break;
-            }
-            val_start--;
-        }
-        // search after conjunction in disjunction
-        if (!val_before) {
-            val_start = con_start + 2;
-            // skip past conjunction
-            std::size_t clause_depth(1);
-            while(clause_depth > 0) {
-                if (str.at(val_start) == '(') clause_depth++;
-                if (str.at(val_start) == ')') clause_depth--;
-                val_start++;
-            }
-            val_start++;
-            // search for literal or conjunction
-            while (str.at(val_start) != ')') {
-                if (
-                    std::isdigit(str.at(val_start)) ||
-                    str.at(val_start) == '-' ||
-                    str.at(val_start) == '*'
-                ) {
-                    val_after = true;
-                    break;
-                }
-                val_start++;
-            }
-        }
-        // find the end of the value
-        std::size_t val_end(val_start + 1);
-        std::string value;
-        if (val_before || val_after) {
-            if (std::isdigit(str.at(val_end))) {
-                while (std::isdigit(str.at(val_end))) val_end++;
-            } else if (str.at(val_end) == '(') {
-                val_end++;
-                std::size_t clause_depth(1);
-                while(clause_depth > 0) {
-                    if (str.at(val_end) == '(') clause_depth++;
-                    if (str.at(val_end) == ')') clause_depth--;
-                    val_end++;
-                }
-                val_end++;
-            }
-            value = str.substr(val_start, val_end - val_start);
-            str.erase(val_start, val_end - val_start);
-            if (val_before) {
-                con_start -= val_end - val_start;
-            }
-        }
-        // distribute the value over the conjunction
-        std::size_t i(con_start + 2);
-        std::size_t clause_depth(1);
-        while (clause_depth > 0) {
-            if (str.at(i) == '(') clause_depth++;
-            if (str.at(i) == ')') clause_depth--;
-            if (
-                // literal
-                std::isdigit(str.at(i)) ||
-                str.at(i) == '-'
-            ) {
-                str.insert(i, "+( ");
-                i += 2;
-                str.insert(i, value);
-                i += val_end - val_start + 1;
-                while (
-                    std::isdigit(str.at(i)) ||
-                    str.at(i) == '-'
-                ) i++;
-                str.insert(i, ")");
-                i++;
-            } else if (
-                // disjunction
-                str.at(i) == '+'
-            ) {
-                str.insert(i, "+( ");
-                i += 2;
-                str.insert(i, value);
-                i += val_end - val_start + 1;
-                while (
-                    str.at(i) != ')'
-                ) i++;
-                str.insert(i, ")");
-                i++;
-            }
-            i++;
+        // count the clauses of each tree
+        std::vector<std::uint32_t> num_clauses(present.size(), 0);
+        for (const clause& cl : clauses) {
+            num_clauses[find(abs(get_clause(cl)[0]))]++;
+        }
+        // give each tree a part, packing the small ones
+        constexpr std::size_t unplaced = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> part(present.size(), unplaced);
+        std::size_t num_parts(0);
+        std::size_t open_part(unplaced);
+        std::size_t open_clauses(0);
+        for (variable var(1); static_cast<std::size_t>(var) < present.size(); var++) {
+            if (find(var) != var || num_clauses[var] == 0) {
+                continue;
+            }
+            if (num_clauses[var] >= min_component_clauses) {
+                part[var] = num_parts++;
+                continue;
+            }
+            if (open_part == unplaced) {
+                open_part = num_parts++;
+                open_clauses = 0;
+            }
+            part[var] = open_part;
+            open_clauses += num_clauses[var];
+            if (open_clauses >= min_component_clauses) {
+                open_part = unplaced;
+            }
+        }
+        if (num_parts < 2) {
+            return {};
         }
-        return true;
-    }
 
-    void remove_operators(std::string& str) {
-        std::string cnf_str;
-        std::size_t i(2);
-        std::size_t clause_depth(1);
-        if (str.at(0) == '+') {
-            while(clause_depth > 0) {
-                if (clause_depth == 2) {
-                    if (str.at(i) != ')') {
-                        cnf_str.push_back(str.at(i));
-                    }
-                }
-                if (str.at(i) == '(') clause_depth++;
-                if (str.at(i) == ')') clause_depth--;
-                i++;
+        // number the variables of each part from one
+        std::vector<component> parts(num_parts);
+        for (component& c : parts) {
+            c.expr.type = type;
+            c.variables.push_back(0);
+        }
+        std::vector<variable> renamed(present.size(), 0);
+        for (variable var(1); static_cast<std::size_t>(var) < present.size(); var++) {
+            if (present[var] && num_clauses[find(var)] > 0) {
+                component& c = parts[part[find(var)]];
+                renamed[var] = c.variables.size();
+                c.variables.push_back(var);
             }
-            cnf_str.push_back('0');
-        } else {
-            while(clause_depth > 0) {
-                if (clause_depth == 2) {
-                    if (str.at(i) != ')') {
-                        cnf_str.push_back(str.at(i));
-                    } else {
-                        cnf_str.push_back('0');
-                    }
-                }
-                if (str.at(i) == '(') clause_depth++;
-                if (str.at(i) == ')') clause_depth--;
-                i++;
+        }
+        std::vector<literal> lits;
+        for (const clause& cl : clauses) {
+            lits.clear();
+            for (const literal& lit : get_clause(cl)) {
+                lits.push_back(lit < 0 ? -renamed[-lit] : renamed[lit]);
             }
+            parts[part[find(abs(get_clause(cl)[0]))]].expr.add_clause(lits);
         }
-        str = cnf_str;
+        for (component& c : parts) {
+            c.expr.max_var = c.variables.size() - 1;
+            c.expr.max_input_var = c.expr.max_var;
+            c.expr.num_input_clauses = c.expr.clauses.size();
+        }
+        return parts;
     }
 
-    inline void convert_str_to_cnf(std::string& str) {
-        // clean string and check formatting
-        while (clean_sat_str(str));
-        // move negation to leaves with Demorgan's Laws
-        while (diminish_complement(str));
-        // distribute disjunctions over conjunctions
-        do {
-            while(clean_sat_str(str));
-        } while (distribute(str));
-        remove_operators(str);
+    // used to print cnf_expr
+    std::ostream& operator<<(std::ostream& ostr, const cnf_expr& expr) {
+        for (const clause& cl : expr.clauses) {
+            ostr << "{ ";
+            for (literal lit : expr.get_clause(cl)) {
+                ostr << lit << " ";
+            }
+            ostr << "}" << std::endl;
+        }
+        return ostr;
     }
-
 }
 
 // a collection of functions used to process problems via I/O
@@ -723,122 +722,491 @@ namespace cnf::io {
         }
     }
 
-    // Given a CNF expression body (via input stream), parse_expression
-    // extracts it contents into a cnf_expr, throwing errors if the
-    // expression is not formatted correctly.
-    inline void parse_expression(
-        std::istream& istr,
-        cnf_expr& expr,
-        variable& max_var,
-        const ProblemType& type,
-        const std::size_t& clauses
-    ) {
-        literal lit;
-        clause cl(1);
-        std::string sat_str;
-        do {
-            // check for a comment line
-            if (istr.peek() == 'c') {
+    // whitespace, as skipped by the stream extraction operators
+    inline bool is_space(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // decimal digits
+    inline bool is_digit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // give the position just past the end of the current line
+    inline const char* skip_line(const char* pos, const char* end) {
+        pos = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        return pos == nullptr ? end : pos + 1;
+    }
+
+    // Given part of a CNF expression body, scan_literals passes each
+    // literal it contains to emit, with zero marking the end of a
+    // clause. Comment lines are skipped. It throws errors if the body
+    // is not formatted correctly.
+    template <typename F>
+    inline void scan_literals(const char* pos, const char* end, variable max_var, F&& emit) {
+        while (pos != end) {
+            const char c = *pos;
+            if (is_space(c)) {
+                pos++;
+                continue;
+            } else if (c == 'c') {
                 // discard the comment line
-                istr.ignore(
-                    std::numeric_limits<std::streamsize>::max(),
-                    '\n'
-                );
+                pos = skip_line(pos, end);
                 continue;
-            } else if (type == ProblemType::CNF) {
-                // check that literal is an integer
-                if (istr >> lit) {
-                    if (std::abs(lit) > max_var) {
-                        // not a valid literal
-                        throw std::invalid_argument(err::invalid_variable);
-                    } else if (lit == 0) {
-                        // increment clause counter
-                        cl++;
-                    } else {
-                        // integer is a valid literal
-                        expr.add_literal(lit, cl);
-                    }
+            }
+            // read the sign
+            bool negative(c == '-');
+            if (c == '-' || c == '+') {
+                pos++;
+            }
+            // check that literal is an integer
+            if (pos == end || !is_digit(*pos)) {
+                throw std::invalid_argument(err::expression_format);
+            }
+            std::int64_t value(0);
+            do {
+                value = 10 * value + (*pos++ - '0');
+                if (value > max_var) {
+                    // not a valid literal
+                    throw std::invalid_argument(err::invalid_variable);
                 }
-            } else {
-                // remove comments and newlines from SAT formatted string
-                std::string line;
-                std::getline(istr, line);
-                sat_str += line;
+            } while (pos != end && is_digit(*pos));
+            emit(static_cast<literal>(negative ? -value : value));
+        }
+    }
+
+    // give the position just past the first clause terminator at or
+    // after the start of the line following pos
+    // every line start is a token boundary, so scanning from one
+    // tokenizes the rest of the body the same way a sequential scan would
+    inline const char* clause_boundary(const char* pos, const char* end) {
+        pos = skip_line(pos, end);
+        while (pos != end) {
+            if (is_space(*pos)) {
+                pos++;
+                continue;
+            } else if (*pos == 'c') {
+                pos = skip_line(pos, end);
+                continue;
+            }
+            const char* token = pos;
+            if (*pos == '-' || *pos == '+') {
+                pos++;
             }
+            bool zero(pos != end && *pos == '0');
+            while (pos != end && !is_space(*pos)) {
+                zero = zero && *pos == '0';
+                pos++;
+            }
+            if (zero && pos != token) {
+                return pos;
+            }
+        }
+        return end;
+    }
 
-        } while (istr.good());
+    // split a CNF expression body into at most the given number of
+    // chunks, each ending with a clause terminator
+    inline std::vector<const char*> split_body(const char* pos, const char* end, std::size_t chunks) {
+        // chunks smaller than this are not worth a thread
+        constexpr std::size_t min_chunk_size = 1 << 20;
+        chunks = std::max<std::size_t>(1, std::min<std::size_t>(chunks, (end - pos) / min_chunk_size));
+        std::vector<const char*> bounds{pos};
+        for (std::size_t k(1); k < chunks && bounds.back() != end; k++) {
+            const char* guess = pos + (end - pos) / chunks * k;
+            bounds.push_back(clause_boundary(std::max(guess, bounds.back()), end));
+        }
+        if (bounds.back() != end) {
+            bounds.push_back(end);
+        }
+        return bounds;
+    }
 
-        if (type == ProblemType::SAT) {
-            // convert the expression to be in conjunctive normal form
-            sat::convert_str_to_cnf(sat_str);
-            // assign the string to the cnf_expr
-            // check that literal is an integer
-            std::stringstream ss(sat_str);
+    // Given the start of a problem, find_problem_line parses its
+    // problem line and gives the position just past it, or nullptr if
+    // there is none. The first line that is neither empty nor a comment
+    // must be the problem line.
+    inline const char* find_problem_line(
+        const char* pos,
+        const char* end,
+        variable& max_var,
+        ProblemType& type,
+        std::size_t& clauses
+    ) {
+        while (pos != end) {
+            const char* next = skip_line(pos, end);
+            if (*pos != '\n' && *pos != 'c') {
+                parse_problem_line(std::string(pos, next - (next[-1] == '\n')), max_var, type, clauses);
+                return next;
+            }
+            pos = next;
+        }
+        return nullptr;
+    }
+
+    // Given a SAT expression body, parse_sat_expression builds its
+    // formula and extracts its clauses into a cnf_expr with the
+    // requested encoding, throwing errors if the expression is not
+    // formatted correctly.
+    inline void parse_sat_expression(
+        const char* pos,
+        const char* end,
+        cnf_expr& expr,
+        const variable& max_var,
+        Encoding encoding
+    ) {
+        sat::formula form;
+        const sat::edge root = sat::parse_formula(form, pos, end, max_var);
+        // every variable named in the formula is part of the problem,
+        // even if simplification removed it
+        for (sat::node_id id(0); id < form.size(); id++) {
+            if (form.get_node(id).kind == sat::op::Var) {
+                expr.add_variable(form.get_node(id).var);
+            }
+        }
+        if (encoding == Encoding::Tseitin) {
+            sat::encode_formula(form, root, expr);
+        } else {
+            sat::expand_formula(form, root, expr);
+        }
+    }
+
+    // read the remainder of a stream in large blocks
+    std::string read_stream(std::istream& istr) {
+        constexpr std::size_t block_size = 1 << 20;
+        std::string text;
+        std::size_t size(0);
+        do {
+            text.resize(size + block_size);
+            istr.read(text.data() + size, block_size);
+            size += istr.gcount();
+        } while (istr);
+        if (istr.bad()) {
+            throw std::ios_base::failure(err::io_err);
+        }
+        text.resize(size);
+        return text;
+    }
+
+    // open a file, mapping it into memory where possible
+    file_view::file_view(const std::string& path): map(nullptr), size(0) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::invalid_argument(err::not_open_file);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            void* addr = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                ::madvise(addr, info.st_size, MADV_SEQUENTIAL);
+                map = addr;
+                size = info.st_size;
+            }
+        }
+        if (map == nullptr) {
+            // pipes and devices cannot be mapped; read them instead
+            constexpr std::size_t block_size = 1 << 20;
+            ssize_t count;
             do {
-                if (ss >> lit) {
-                    if (lit == std::numeric_limits<variable>::max() - 1) {
-                        expr.add_literal(lit, cl);
-                        expr.assign_and_simplify(abs(lit), true);
-                        expr.remove_variable(abs(lit));
-                    } else if (lit == std::numeric_limits<variable>::min() + 1) {
-                        expr.add_literal(lit, cl);
-                        expr.assign_and_simplify(abs(lit), true);
-                        expr.remove_variable(abs(lit));
-                    } else if (std::abs(lit) > max_var) {
-                        // not a valid literal
-                        throw std::invalid_argument(err::invalid_variable);
-                    } else if (lit == 0) {
-                        // increment clause counter
-                        cl++;
-                    } else {
-                        // integer is a valid literal
-                        expr.add_literal(lit, cl);
-                    }
-                }
-            } while (ss.good());
+                buffer.resize(size + block_size);
+                count = ::read(fd, buffer.data() + size, block_size);
+                size += std::max<ssize_t>(count, 0);
+            } while (count > 0 || (count < 0 && errno == EINTR));
+            buffer.resize(size);
+            if (count < 0) {
+                ::close(fd);
+                throw std::ios_base::failure(err::io_err);
+            }
         }
+        ::close(fd);
+    }
 
-        // ensure the correct number of clauses was provided
-        if (type == ProblemType::CNF && cl != clauses + 1) {
-            throw std::invalid_argument(err::wrong_number_clauses);
+    // release the mapping
+    file_view::~file_view() {
+        if (map != nullptr) {
+            ::munmap(map, size);
+        }
+    }
+
+    // give the contents of the file
+    std::string_view file_view::contents() const {
+        if (map != nullptr) {
+            return std::string_view(static_cast<const char*>(map), size);
         }
+        return buffer;
     }
 
     // extract_cnf_problem accepts a CNF-formatted problem
     // specification via an input stream and returns a cnf_expr.
     // It throws exceptions if the provided input cannot be read.
-    cnf_expr& extract_cnf_problem(cnf_expr& expr, std::istream& istr) {
-        // needed for parsing
-        std::string line;
+    cnf_expr& extract_cnf_problem(cnf_expr& expr, std::istream& istr, unsigned threads, Encoding encoding) {
+        return extract_cnf_problem(expr, read_stream(istr), threads, encoding);
+    }
+
+    // read_cnf_problem accepts the path of a CNF-formatted problem
+    // specification and returns a cnf_expr, reading the file through
+    // a memory map. It throws exceptions if the file cannot be read.
+    cnf_expr& read_cnf_problem(cnf_expr& expr, const std::string& path, unsigned threads, Encoding encoding) {
+        file_view file(path);
+        return extract_cnf_problem(expr, file.contents(), threads, encoding);
+    }
+
+    // extract_cnf_problem accepts the text of a CNF-formatted problem
+    // specification and returns a cnf_expr. It throws exceptions if
+    // the problem is not formatted correctly. Large CNF bodies are split
+    // at clause terminators and parsed by up to the given number of
+    // threads, with the clauses merged back in their original order.
+    // SAT formulas are converted to clauses with the given encoding.
+    cnf_expr& extract_cnf_problem(cnf_expr& expr, std::string_view text, unsigned threads, Encoding encoding) {
+        if (is_binary_problem(text)) {
+            return load_binary_problem(expr, text);
+        }
+        if (detect_compression(text) != compression::None) {
+            return extract_compressed_problem(expr, text, threads, encoding);
+        }
+        const char* const end = text.data() + text.size();
         std::size_t clauses;
 
         // find and parse the problem line
-        while (std::getline(istr, line).good()) {
-            // first non-ignored line must be problem line
-            // empty lines and comment lines are ignored
-            if (line.size() != 0 && line.at(0) != 'c') {
-                parse_problem_line(line, expr.max_var, expr.type, clauses);
-                break;
-            }
-        }
-        // ensure no errors occurred while reading problem
-        if (!istr) {
+        const char* pos = find_problem_line(text.data(), end, expr.max_var, expr.type, clauses);
+        if (pos == nullptr) {
             throw std::ios_base::failure(err::io_err);
         }
+        expr.reserve_variable(expr.max_var);
+        expr.max_input_var = expr.max_var;
 
         // parse the expression body
-        parse_expression(istr, expr, expr.max_var, expr.type, clauses);
-        // ensure no errors occurred while reading expression
-        if (istr.bad()) {
-            // likely an I/O error
-            throw std::ios_base::failure(err::io_err);
-        } else if (!istr.eof()) {
-            // likely an invalid expression
-            throw std::invalid_argument(err::expression_format);
+        const std::vector<const char*> bounds = split_body(pos, end, threads);
+        if (expr.type == ProblemType::CNF && bounds.size() > 2) {
+            // parse each chunk into a clause block on its own thread
+            const std::size_t chunks = bounds.size() - 1;
+            std::vector<std::vector<literal>> blocks(chunks);
+            std::vector<std::exception_ptr> errors(chunks);
+            {
+                std::vector<std::jthread> workers;
+                for (std::size_t k(0); k < chunks; k++) {
+                    workers.emplace_back([&, k]() {
+                        try {
+                            expr.parse_block(bounds[k], bounds[k + 1], blocks[k]);
+                        } catch (...) {
+                            errors[k] = std::current_exception();
+                        }
+                    });
+                }
+            }
+            // report the first error in the text
+            for (const std::exception_ptr& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+            // merge the blocks in clause order
+            expr.clauses.reserve(clauses);
+            for (std::vector<literal>& block : blocks) {
+                expr.append_block(block);
+                std::vector<literal>().swap(block);
+            }
+            // ensure the correct number of clauses was provided
+            if (expr.clauses.size() != clauses) {
+                throw std::invalid_argument(err::wrong_number_clauses);
+            }
+        } else if (expr.type == ProblemType::CNF) {
+            // literals are written straight into the clause store
+            expr.clauses.reserve(clauses);
+            std::size_t cl(0);
+            clause open(no_clause);
+            scan_literals(pos, end, expr.max_var, [&](literal lit) {
+                if (open == no_clause) {
+                    open = expr.open_clause();
+                }
+                if (lit == 0) {
+                    // the clause is complete
+                    expr.close_clause(open);
+                    open = no_clause;
+                    cl++;
+                } else {
+                    expr.append_literal(open, lit);
+                }
+            });
+            // every clause must end with a terminating zero
+            if (open != no_clause) {
+                throw std::invalid_argument(err::wrong_number_clauses);
+            }
+            // ensure the correct number of clauses was provided
+            if (cl != clauses) {
+                throw std::invalid_argument(err::wrong_number_clauses);
+            }
+        } else {
+            parse_sat_expression(pos, end, expr, expr.max_input_var, encoding);
+        }
+
+        // expr was generated successfully
+        expr.normalize();
+        expr.index_occurrences();
+        expr.shrink_to_fit();
+        return expr;
+    }
+
+    // extract_compressed_problem accepts gzip or xz compressed problem
+    // text and returns a cnf_expr. The text is decompressed on another
+    // thread while CNF clauses are parsed from the blocks already
+    // decompressed, so the whole text is never held in memory at once.
+    // SAT and binary problems are decompressed in full before parsing.
+    cnf_expr& extract_compressed_problem(cnf_expr& expr, std::string_view text, unsigned threads, Encoding encoding) {
+        // a CNF body is parsed once this much text is waiting
+        constexpr std::size_t min_parse_size = 1 << 20;
+        // clause terminators are looked for this far back from the end
+        constexpr std::size_t boundary_window = 1 << 16;
+
+        decompressor source(text);
+        std::string pending;
+        std::string block;
+        bool more(true);
+        auto read_block = [&]() {
+            more = source.next(block);
+            if (more) {
+                pending += block;
+            }
+        };
+
+        // find and parse the problem line
+        std::size_t clauses;
+        const char* body(nullptr);
+        while (body == nullptr) {
+            read_block();
+            if (pending.size() >= 8 || !more) {
+                if (is_binary_problem(pending) || detect_compression(pending) != compression::None) {
+                    // decompress the rest and load it as it is
+                    while (more) {
+                        read_block();
+                    }
+                    return extract_cnf_problem(expr, pending, threads, encoding);
+                }
+            }
+            // only complete lines are searched until the text ends
+            std::size_t lines = more ? pending.rfind('\n') + 1 : pending.size();
+            body = find_problem_line(pending.data(), pending.data() + lines, expr.max_var, expr.type, clauses);
+            if (body == nullptr && !more) {
+                throw std::ios_base::failure(err::io_err);
+            }
+        }
+        expr.reserve_variable(expr.max_var);
+        expr.max_input_var = expr.max_var;
+        std::size_t start = body - pending.data();
+
+        if (expr.type == ProblemType::SAT) {
+            while (more) {
+                read_block();
+            }
+            parse_sat_expression(pending.data() + start, pending.data() + pending.size(), expr, expr.max_input_var, encoding);
+        } else {
+            // parse up to the last clause terminator in the complete lines
+            // each time enough text is waiting, and the rest at the end
+            expr.clauses.reserve(clauses);
+            std::vector<literal> parsed;
+            while (true) {
+                const char* first = pending.data() + start;
+                const char* last = pending.data() + pending.size();
+                if (more) {
+                    const std::size_t lines = pending.rfind('\n') + 1;
+                    if (lines <= start || lines - start < min_parse_size) {
+                        read_block();
+                        continue;
+                    }
+                    last = pending.data() + lines;
+                    // only complete lines are searched, since a zero at the
+                    // end of the waiting text may begin a longer token
+                    const char* boundary = clause_boundary(
+                        std::max(first, last - boundary_window), last
+                    );
+                    if (boundary == last) {
+                        boundary = clause_boundary(first, last);
+                    }
+                    if (boundary == last) {
+                        // no clause ends in the waiting text yet
+                        read_block();
+                        continue;
+                    }
+                    last = boundary;
+                }
+                parsed.clear();
+                expr.parse_block(first, last, parsed);
+                expr.append_block(parsed);
+                if (!more) {
+                    break;
+                }
+                // drop the parsed text and wait for more
+                pending.erase(0, last - pending.data());
+                start = 0;
+                read_block();
+            }
+            // ensure the correct number of clauses was provided
+            if (expr.clauses.size() != clauses) {
+                throw std::invalid_argument(err::wrong_number_clauses);
+            }
         }
 
         // expr was generated successfully
+        expr.normalize();
+        expr.index_occurrences();
+        expr.shrink_to_fit();
         return expr;
     }
 
 }
+
+// clause blocks used when parsing in parallel
+namespace cnf {
+
+    // parse part of a CNF body into a block of clauses in arena layout
+    // the block does not refer to the expression, so blocks can be
+    // parsed concurrently
+    void cnf_expr::parse_block(const char* pos, const char* end, std::vector<literal>& block) const {
+        std::size_t open(block.size());
+        bool is_open(false);
+        io::scan_literals(pos, end, max_var, [&](literal lit) {
+            if (!is_open) {
+                open = block.size();
+                block.insert(block.end(), header_size, 0);
+                is_open = true;
+            }
+            if (lit == 0) {
+                // the clause is complete
+                block[open] = block.size() - open - header_size;
+                is_open = false;
+            } else if (std::find(block.begin() + open + header_size, block.end(), lit) == block.end()) {
+                // duplicate literals are merged
+                block.push_back(lit);
+            }
+        });
+        // every block ends with a clause terminator, so an open clause
+        // is missing its terminating zero
+        if (is_open) {
+            throw std::invalid_argument(err::wrong_number_clauses);
+        }
+    }
+
+    // append a block of parsed clauses, making them active
+    void cnf_expr::append_block(lit_span block) {
+        if (arena.size() + block.size() >= no_clause) {
+            throw std::length_error(err::expression_size);
+        }
+        clause cl = arena.size();
+        arena.insert(arena.end(), block.begin(), block.end());
+        for (; cl < arena.size(); cl += header_size + arena[cl]) {
+            for (const literal& lit : get_clause(cl)) {
+                add_variable(abs(lit));
+                count_literal(lit);
+            }
+            arena[cl + 1] = clauses.size();
+            arena[cl + 2] = 0;
+            if (arena[cl] == 0) {
+                num_empty++;
+            } else if (arena[cl] == 1) {
+                queue_unit(cl);
+            }
+            clauses.push_back(cl);
+        }
+    }
+
+}
@@ -0,0 +1,190 @@
+// compressed.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "compressed.hpp"
+#include "message.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#ifdef SAT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SAT_HAVE_LZMA
+#include <lzma.h>
+#endif
+
+namespace cnf::io {
+
+    // the size of a decompressed block
+    constexpr std::size_t block_size = 1 << 20;
+
+    // the number of blocks that may wait to be read
+    constexpr std::size_t max_waiting_blocks = 8;
+
+    // recognise the compression of some data from its magic bytes
+    compression detect_compression(std::string_view data) {
+        if (data.size() >= 2 && data[0] == '\x1f' && data[1] == '\x8b') {
+            return compression::Gzip;
+        } else if (data.size() >= 6 && std::memcmp(data.data(), "\xfd" "7zXZ\0", 6) == 0) {
+            return compression::Xz;
+        }
+        return compression::None;
+    }
+
+    // check whether this build can decompress a format
+    bool can_decompress(compression format) {
+        switch (format) {
+        case compression::None:
+            return true;
+        case compression::Gzip:
+#ifdef SAT_HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case compression::Xz:
+#ifdef SAT_HAVE_LZMA
+            return true;
+#else
+            return false;
+#endif
+        }
+        return false;
+    }
+
+    // compressed data constructor
+    decompressor::decompressor(std::string_view compressed):
+        data(compressed),
+        format(detect_compression(compressed)),
+        finished(false)
+    {
+        if (!can_decompress(format)) {
+            throw std::invalid_argument(err::compression_unsupported);
+        }
+        worker = std::jthread([this](std::stop_token stop) { run(stop); });
+    }
+
+    // give the next block of text; returns false once all text is given
+    bool decompressor::next(std::string& block) {
+        std::unique_lock lock(m);
+        changed.wait(lock, [&]() { return !blocks.empty() || finished; });
+        if (!blocks.empty()) {
+            block = std::move(blocks.front());
+            blocks.pop_front();
+            changed.notify_all();
+            return true;
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return false;
+    }
+
+    // hand a finished block to the reader, waiting for room
+    // returns false if the worker was asked to stop
+    bool decompressor::deliver(std::stop_token stop, std::string& block) {
+        std::unique_lock lock(m);
+        if (!changed.wait(lock, stop, [&]() { return blocks.size() < max_waiting_blocks; })) {
+            return false;
+        }
+        blocks.push_back(std::move(block));
+        block.clear();
+        changed.notify_all();
+        return true;
+    }
+
+    // decompress the data into the queue
+    void decompressor::run(std::stop_token stop) {
+        try {
+            std::string block;
+            std::size_t size(0);
+#ifdef SAT_HAVE_ZLIB
+            if (format == compression::Gzip) {
+                z_stream zs{};
+                // 32 selects automatic detection of the gzip header
+                if (inflateInit2(&zs, 15 + 32) != Z_OK) {
+                    throw std::runtime_error(err::compressed_format);
+                }
+                std::size_t consumed(0);
+                int status(Z_OK);
+                while (!stop.stop_requested()) {
+                    if (zs.avail_in == 0 && consumed < data.size()) {
+                        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data() + consumed));
+                        zs.avail_in = std::min<std::size_t>(data.size() - consumed, UINT_MAX);
+                        consumed += zs.avail_in;
+                    }
+                    block.resize(block_size);
+                    zs.next_out = reinterpret_cast<Bytef*>(block.data() + size);
+                    zs.avail_out = block_size - size;
+                    status = inflate(&zs, Z_NO_FLUSH);
+                    size = block_size - zs.avail_out;
+                    if (status == Z_STREAM_END && (zs.avail_in > 0 || consumed < data.size())) {
+                        // another gzip member follows
+                        inflateReset(&zs);
+                        status = Z_OK;
+                    }
+                    if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+                        inflateEnd(&zs);
+                        throw std::runtime_error(err::compressed_format);
+                    }
+                    const bool done = status == Z_STREAM_END ||
+                        (status == Z_BUF_ERROR && zs.avail_in == 0 && consumed == data.size());
+                    if (size == block_size || (done && size > 0)) {
+                        block.resize(size);
+                        size = 0;
+                        if (!deliver(stop, block)) break;
+                    }
+                    if (done) {
+                        if (status != Z_STREAM_END) {
+                            // the data ends in the middle of a member
+                            inflateEnd(&zs);
+                            throw std::runtime_error(err::compressed_format);
+                        }
+                        break;
+                    }
+                }
+                inflateEnd(&zs);
+            }
+#endif
+#ifdef SAT_HAVE_LZMA
+            if (format == compression::Xz) {
+                lzma_stream xs = LZMA_STREAM_INIT;
+                if (lzma_stream_decoder(&xs, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+                    throw std::runtime_error(err::compressed_format);
+                }
+                xs.next_in = reinterpret_cast<const std::uint8_t*>(data.data());
+                xs.avail_in = data.size();
+                lzma_ret status(LZMA_OK);
+                while (!stop.stop_requested()) {
+                    block.resize(block_size);
+                    xs.next_out = reinterpret_cast<std::uint8_t*>(block.data() + size);
+                    xs.avail_out = block_size - size;
+                    // all input is given at once, so the stream can be finished
+                    status = lzma_code(&xs, LZMA_FINISH);
+                    size = block_size - xs.avail_out;
+                    if (status != LZMA_OK && status != LZMA_STREAM_END) {
+                        lzma_end(&xs);
+                        throw std::runtime_error(err::compressed_format);
+                    }
+                    if (size == block_size || (status == LZMA_STREAM_END && size > 0)) {
+                        block.resize(size);
+                        size = 0;
+                        if (!deliver(stop, block)) break;
+                    }
+                    if (status == LZMA_STREAM_END) break;
+                }
+                lzma_end(&xs);
+            }
+#endif
+        } catch (...) {
+            std::scoped_lock lock(m);
+            error = std::current_exception();
+        }
+        std::scoped_lock lock(m);
+        finished = true;
+        changed.notify_all();
+    }
+
+}
@@ -0,0 +1,467 @@
+// formula.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "formula.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace cnf::sat {
+
+    // will need abs frequently
+    using std::abs;
+
+    // child conjunctions with at most this many children are flattened
+    // into their parents; larger ones stay shared
+    constexpr std::uint32_t flatten_limit = 16;
+
+    // default constructor
+    // the constant node comes first, so false_edge and true_edge refer to it
+    formula::formula(): nodes{{op::Const, 0, 0, 0}}, unique(1024, 0), num_unique(0) {}
+
+    // give the hash of a list of children
+    std::uint64_t formula::hash_children(std::span<const edge> children) {
+        std::uint64_t hash(14695981039346656037ull);
+        for (const edge& e : children) {
+            hash = (hash ^ e) * 1099511628211ull;
+        }
+        return hash ^ (hash >> 29);
+    }
+
+    // give the edge for a literal
+    edge formula::add_literal(literal lit) {
+        const variable var = abs(lit);
+        if (var_nodes.size() <= static_cast<std::size_t>(var)) {
+            var_nodes.resize(var + 1, 0);
+        }
+        if (var_nodes[var] == 0) {
+            var_nodes[var] = nodes.size();
+            nodes.push_back({op::Var, var, 0, 0});
+        }
+        return 2 * var_nodes[var] + (lit < 0);
+    }
+
+    // give the edge for a conjunction (true) or disjunction (false) of edges
+    // the result is simplified, and reuses an equal node if there is one
+    edge formula::add_operator(bool conjunction, std::span<const edge> children) {
+        // a disjunction is the negation of the conjunction of the negations
+        const edge flip = conjunction ? 0 : 1;
+        scratch.clear();
+        for (const edge& child : children) {
+            const edge e = child ^ flip;
+            const node& current = nodes[node_of(e)];
+            if (e == true_edge) {
+                // true conjuncts have no effect
+                continue;
+            } else if (e == false_edge) {
+                return false_edge ^ flip;
+            } else if (current.kind == op::And && !is_negated(e) && current.count <= flatten_limit) {
+                // a small conjunction is merged into this one
+                scratch.insert(
+                    scratch.end(),
+                    edges.begin() + current.first,
+                    edges.begin() + current.first + current.count
+                );
+            } else {
+                scratch.push_back(e);
+            }
+        }
+        // merge repeated children; a node and its negation end up adjacent
+        std::sort(scratch.begin(), scratch.end());
+        scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+        for (std::size_t i(1); i < scratch.size(); i++) {
+            if ((scratch[i] ^ scratch[i - 1]) == 1) {
+                return false_edge ^ flip;
+            }
+        }
+        if (scratch.empty()) {
+            return true_edge ^ flip;
+        } else if (scratch.size() == 1) {
+            return scratch[0] ^ flip;
+        }
+        // look for an equal conjunction
+        const std::size_t mask = unique.size() - 1;
+        std::size_t slot = hash_children(scratch) & mask;
+        for (; unique[slot] != 0; slot = (slot + 1) & mask) {
+            if (std::ranges::equal(get_children(unique[slot]), scratch)) {
+                return 2 * unique[slot] ^ flip;
+            }
+        }
+        if (
+            nodes.size() >= std::numeric_limits<edge>::max() / 2 ||
+            edges.size() + scratch.size() >= std::numeric_limits<std::uint32_t>::max()
+        ) {
+            throw std::length_error(err::expression_size);
+        }
+        const node_id id = nodes.size();
+        nodes.push_back({
+            op::And,
+            0,
+            static_cast<std::uint32_t>(edges.size()),
+            static_cast<std::uint32_t>(scratch.size())
+        });
+        edges.insert(edges.end(), scratch.begin(), scratch.end());
+        unique[slot] = id;
+        // keep the table at most half full
+        if (2 * ++num_unique > unique.size()) {
+            std::vector<node_id> table(2 * unique.size(), 0);
+            const std::size_t new_mask = table.size() - 1;
+            for (const node_id& entry : unique) {
+                if (entry == 0) continue;
+                std::size_t pos = hash_children(get_children(entry)) & new_mask;
+                while (table[pos] != 0) {
+                    pos = (pos + 1) & new_mask;
+                }
+                table[pos] = entry;
+            }
+            unique = std::move(table);
+        }
+        return 2 * id ^ flip;
+    }
+
+    // give the negation of an edge
+    edge formula::add_negation(edge e) const {
+        return e ^ 1;
+    }
+
+    // give a node
+    const node& formula::get_node(node_id id) const {
+        return nodes[id];
+    }
+
+    // give the children of a node
+    std::span<const edge> formula::get_children(node_id id) const {
+        return std::span<const edge>(edges.data() + nodes[id].first, nodes[id].count);
+    }
+
+    // give the number of nodes
+    std::size_t formula::size() const {
+        return nodes.size();
+    }
+
+    // whitespace, as skipped by the stream extraction operators
+    inline bool is_space(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // decimal digits
+    inline bool is_digit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // Given the body of a SAT problem, parse_formula builds its formula
+    // in a single pass, throwing errors if the body is not formatted
+    // correctly. Nesting is tracked on an explicit stack, so deeply
+    // nested formulas cannot overflow the call stack.
+    edge parse_formula(formula& form, const char* pos, const char* end, variable max_var) {
+        // the kind of an unfinished formula
+        enum class form_kind {
+            // +( or *( awaiting its remaining formulas
+            List,
+            // ( awaiting its formula
+            Group,
+            // - awaiting the formula it negates
+            Negation
+        };
+        struct frame {
+            form_kind kind;
+            // whether a list is a conjunction
+            bool conjunction;
+            // where the list's formulas begin in the operand stack
+            std::size_t first;
+        };
+        std::vector<frame> stack;
+        // the finished formulas of every open list
+        std::vector<edge> operands;
+
+        // skip whitespace and comment lines
+        bool line_start(true);
+        auto skip = [&]() {
+            while (pos != end) {
+                if (line_start && *pos == 'c') {
+                    // discard the comment line
+                    while (pos != end && *pos != '\n') pos++;
+                } else if (is_space(*pos)) {
+                    line_start = *pos++ == '\n';
+                } else {
+                    line_start = false;
+                    return;
+                }
+            }
+        };
+        // read a variable name
+        auto read_variable = [&]() -> variable {
+            std::int64_t value(0);
+            while (pos != end && is_digit(*pos)) {
+                value = 10 * value + (*pos++ - '0');
+                if (value > max_var) {
+                    // not a valid literal
+                    throw std::invalid_argument(err::invalid_variable);
+                }
+            }
+            if (value == 0) {
+                throw std::invalid_argument(err::expression_format);
+            }
+            return value;
+        };
+
+        edge result(false_edge);
+        bool have_result(false);
+        while (true) {
+            if (have_result) {
+                // hand the finished formula to the one containing it
+                if (stack.empty()) {
+                    break;
+                }
+                frame& top = stack.back();
+                if (top.kind == form_kind::List) {
+                    operands.push_back(result);
+                    have_result = false;
+                } else if (top.kind == form_kind::Group) {
+                    skip();
+                    if (pos == end || *pos != ')') {
+                        throw std::invalid_argument(err::expression_format);
+                    }
+                    pos++;
+                    stack.pop_back();
+                } else {
+                    result = form.add_negation(result);
+                    stack.pop_back();
+                }
+                continue;
+            }
+            skip();
+            if (pos == end) {
+                throw std::invalid_argument(err::expression_format);
+            }
+            // close a finished list
+            if (*pos == ')' && !stack.empty() && stack.back().kind == form_kind::List) {
+                pos++;
+                const std::size_t first = stack.back().first;
+                result = form.add_operator(
+                    stack.back().conjunction,
+                    std::span<const edge>(operands.data() + first, operands.size() - first)
+                );
+                have_result = true;
+                operands.resize(first);
+                stack.pop_back();
+                continue;
+            }
+            // begin a formula
+            if (is_digit(*pos)) {
+                result = form.add_literal(read_variable());
+                have_result = true;
+            } else if (*pos == '-') {
+                pos++;
+                skip();
+                if (pos != end && is_digit(*pos)) {
+                    result = form.add_literal(-read_variable());
+                    have_result = true;
+                } else {
+                    stack.push_back({form_kind::Negation, false, 0});
+                }
+            } else if (*pos == '+' || *pos == '*') {
+                const bool conjunction = *pos++ == '*';
+                skip();
+                if (pos == end || *pos != '(') {
+                    throw std::invalid_argument(err::expression_format);
+                }
+                pos++;
+                stack.push_back({form_kind::List, conjunction, operands.size()});
+            } else if (*pos == '(') {
+                pos++;
+                stack.push_back({form_kind::Group, false, 0});
+            } else {
+                throw std::invalid_argument(err::expression_format);
+            }
+        }
+        // the body must hold exactly one formula
+        skip();
+        if (pos != end) {
+            throw std::invalid_argument(err::expression_format);
+        }
+        return result;
+    }
+
+    // Given a formula, expand_formula adds its clauses to an expression.
+    // Conjunctions collect the clauses of their children, and
+    // disjunctions take the product of them, so the result is equivalent
+    // to the formula but may be exponentially larger.
+    void expand_formula(const formula& form, edge root, cnf_expr& expr) {
+        using clause_set = std::vector<std::vector<literal>>;
+        struct frame {
+            edge e;
+            std::uint32_t next;
+            clause_set clauses;
+        };
+        // true has no clauses; false has one empty clause
+        // a negated conjunction is the disjunction of its negated children
+        auto open = [&](edge e) -> frame {
+            const node& current = form.get_node(node_of(e));
+            if (current.kind == op::Var) {
+                return {e, 0, clause_set{{is_negated(e) ? -current.var : current.var}}};
+            } else if (is_negated(e) == (current.kind == op::And)) {
+                return {e, 0, clause_set{{}}};
+            }
+            return {e, 0, clause_set{}};
+        };
+        std::vector<frame> stack{open(root)};
+        while (true) {
+            frame& top = stack.back();
+            const node& current = form.get_node(node_of(top.e));
+            if (current.kind == op::And && top.next < current.count) {
+                // expand the next child first
+                const edge child = form.get_children(node_of(top.e))[top.next++];
+                stack.push_back(open(child ^ is_negated(top.e)));
+                continue;
+            }
+            // the node is complete
+            clause_set result = std::move(top.clauses);
+            stack.pop_back();
+            if (stack.empty()) {
+                for (const std::vector<literal>& cl : result) {
+                    expr.add_clause(cl);
+                }
+                return;
+            }
+            frame& parent = stack.back();
+            if (!is_negated(parent.e)) {
+                // conjunction: keep every clause
+                parent.clauses.insert(
+                    parent.clauses.end(),
+                    std::make_move_iterator(result.begin()),
+                    std::make_move_iterator(result.end())
+                );
+            } else {
+                // disjunction: join every pair of clauses
+                if (
+                    !result.empty() &&
+                    parent.clauses.size() > std::numeric_limits<clause>::max() / result.size()
+                ) {
+                    throw std::length_error(err::expression_size);
+                }
+                clause_set product;
+                product.reserve(parent.clauses.size() * result.size());
+                for (const std::vector<literal>& left : parent.clauses) {
+                    for (const std::vector<literal>& right : result) {
+                        product.push_back(left);
+                        product.back().insert(product.back().end(), right.begin(), right.end());
+                    }
+                }
+                parent.clauses = std::move(product);
+            }
+        }
+    }
+
+    // Given a formula, encode_formula adds clauses to an expression that
+    // are satisfiable exactly when the formula is, using the
+    // Plaisted-Greenbaum encoding. The top of the formula is asserted
+    // directly: conjunctions by asserting each child, and disjunctions as
+    // a single clause. Each conjunction below it gets a new variable x,
+    // with clauses for x implying the conjunction where it is used
+    // positively, and for the converse where it is used negatively.
+    // Every node is encoded once, however often it is shared, so the
+    // clauses grow linearly with the formula.
+    void encode_formula(const formula& form, edge root, cnf_expr& expr) {
+        // the polarities in which a node is needed or asserted
+        constexpr std::uint8_t positive = 1;
+        constexpr std::uint8_t negative = 2;
+        auto polarity = [&](edge e) -> std::uint8_t {
+            return is_negated(e) ? negative : positive;
+        };
+        std::vector<std::uint8_t> needed(form.size(), 0);
+        std::vector<std::uint8_t> asserted(form.size(), 0);
+
+        // find the asserted top of the formula; the edges that are not
+        // asserted conjunctions each give one clause
+        std::vector<edge> top;
+        std::vector<edge> pending{root};
+        while (!pending.empty()) {
+            const edge e = pending.back();
+            pending.pop_back();
+            if (asserted[node_of(e)] & polarity(e)) continue;
+            asserted[node_of(e)] |= polarity(e);
+            const node& current = form.get_node(node_of(e));
+            const std::span<const edge> children = form.get_children(node_of(e));
+            if (current.kind == op::And && !is_negated(e)) {
+                // every conjunct is asserted, in order
+                pending.insert(pending.end(), children.rbegin(), children.rend());
+            } else {
+                top.push_back(e);
+                for (const edge& child : children) {
+                    needed[node_of(child)] |= polarity(child ^ 1);
+                }
+            }
+        }
+
+        // pass the polarities down; children come before their parents
+        for (node_id id(form.size() - 1); id > 0; id--) {
+            for (const edge& child : form.get_children(id)) {
+                if (needed[id] & positive) {
+                    needed[node_of(child)] |= polarity(child);
+                }
+                if (needed[id] & negative) {
+                    needed[node_of(child)] |= polarity(child ^ 1);
+                }
+            }
+        }
+
+        // give each needed conjunction a variable
+        std::vector<literal> lits(form.size(), 0);
+        for (node_id id(1); id < form.size(); id++) {
+            const node& current = form.get_node(id);
+            if (current.kind == op::Var) {
+                lits[id] = current.var;
+            } else if (needed[id] != 0) {
+                lits[id] = expr.new_variable();
+            }
+        }
+        auto literal_of = [&](edge e) -> literal {
+            return is_negated(e) ? -lits[node_of(e)] : lits[node_of(e)];
+        };
+
+        // add the clauses of the asserted top
+        std::vector<literal> cl;
+        for (const edge& e : top) {
+            cl.clear();
+            const node& current = form.get_node(node_of(e));
+            if (current.kind == op::Var) {
+                cl.push_back(literal_of(e));
+            } else if (e == true_edge) {
+                continue;
+            }
+            // a negated conjunction is the disjunction of its negated
+            // children; false is the empty clause
+            for (const edge& child : form.get_children(node_of(e))) {
+                cl.push_back(literal_of(child ^ 1));
+            }
+            expr.add_clause(cl);
+        }
+
+        // add the clauses defining each variable
+        std::vector<literal> children;
+        for (node_id id(1); id < form.size(); id++) {
+            if (form.get_node(id).kind != op::And || needed[id] == 0) continue;
+            const literal var = lits[id];
+            children.clear();
+            for (const edge& child : form.get_children(id)) {
+                children.push_back(literal_of(child));
+            }
+            if (needed[id] & positive) {
+                for (const literal& lit : children) {
+                    cl = {-var, lit};
+                    expr.add_clause(cl);
+                }
+            }
+            if (needed[id] & negative) {
+                cl = {var};
+                for (const literal& lit : children) {
+                    cl.push_back(-lit);
+                }
+                expr.add_clause(cl);
+            }
+            expr.define_variable(var, true, children);
+        }
+    }
+
+}
@@ -6,7 +6,12 @@
 #include "solve.hpp"
 #include "solver.hpp"
 #include <fstream>
+#include <map>
+#include <set>
+#include <string>
 #include <limits>
+#include <memory>
+#include <exception>
 #include <stdexcept>
 #include <unistd.h>
 #include "message.hpp"
@@ -18,23 +23,37 @@ namespace solve {
 
     // constructor
     orchestrator::orchestrator(const program_interface& program_if):
+        orchestrator(program_if, program_if.threads, std::chrono::steady_clock::now() + program_if.duration)
+    {}
+
+    // component constructor
+    orchestrator::orchestrator(
+        const program_interface& program_if,
+        uint share,
+        std::chrono::steady_clock::time_point end
+    ):
         pif (program_if),
+        num_threads(share),
+        deadline(end),
         finished(false),
         active_divided_threads(0),
         active_incomplete_threads(0),
         status(Status::Success)
     {
-        threads.reserve(pif.threads);
+        threads.reserve(num_threads);
     }
 
     inline bool vmem_usage(long int&);
 
 
-    // run the solvers
-    std::pair<Status, sol::solution> orchestrator::operator()(const cnf::cnf_expr& expr) {
+    // run the solvers on a preprocessed expression
+    std::pair<Status, sol::solution> orchestrator::operator()(
+        const cnf::cnf_expr& expr,
+        const preprocess::preprocessor& pre
+    ) {
         // prepare the default solution if none is found
-        sol.set_max_var(expr.get_max_var());
-        sol.set_num_clauses(expr.get_num_clauses());
+        sol.set_max_var(expr.get_max_input_var());
+        sol.set_num_clauses(expr.get_num_input_clauses());
         sol.set_type(static_cast<sol::ProblemType>(expr.get_type()));
 
         if (sig != 0) {
@@ -44,6 +63,45 @@ namespace solve {
             return {Status::IntSig, sol};
         }
 
+        // independent parts of the problem are solved separately
+        std::vector<cnf::component> parts = expr.components();
+        if (parts.empty()) {
+            search(expr);
+        } else {
+            search_components(parts);
+        }
+
+        // assign arbitrary values to any remaining variables
+        for (auto const& var : expr.variables()) {
+            if (!sol.assignment().is_assigned(var)) {
+                sol.assign_variable(var, true);
+            }
+        }
+        // give values to the variables removed by preprocessing
+        if (sol.is_valid()) {
+            pre.extend(sol);
+        }
+        // variables introduced by encoding the problem are not reported
+        sol.truncate(expr.get_max_input_var());
+        // clauses removed while reading the problem
+        sol.stats().insert({"TAUTOLOGIES_REMOVED", std::to_string(expr.num_tautologies())});
+        sol.stats().insert({"DUPLICATE_CLAUSES_REMOVED", std::to_string(expr.num_duplicates())});
+        // reductions made by preprocessing
+        pre.report(sol.stats());
+
+        return std::make_pair(status, sol);
+    }
+
+    // run the solvers on an expression until one finishes
+    void orchestrator::search(const cnf::cnf_expr& expr) {
+        // an expression holding an empty clause, such as one found
+        // unsatisfiable by preprocessing, needs no search
+        if (expr.empty_clause()) {
+            std::scoped_lock lock(m);
+            finished = true;
+            pif.message(2, "no solution exists");
+        }
+
         // set the number of threads used for DPLL
         uint num_dpll_threads(0);
         if (
@@ -51,17 +109,17 @@ namespace solve {
             pif.solver == solver::SolverType::DPLL
         ) {
             num_dpll_threads = 1;
-            while (num_dpll_threads*2 <= pif.threads) num_dpll_threads *= 2;
+            while (num_dpll_threads*2 <= num_threads) num_dpll_threads *= 2;
             active_divided_threads = num_dpll_threads;
         }
 
         // set the number of threads used for LocalSearch
         uint num_local_search_threads(0);
         if (pif.solver == solver::SolverType::Auto) {
-            num_local_search_threads = pif.threads - num_dpll_threads;
+            num_local_search_threads = num_threads - num_dpll_threads;
             active_incomplete_threads = num_local_search_threads;
         } else if (pif.solver == solver::SolverType::LocalSearch) {
-            num_local_search_threads = pif.threads;
+            num_local_search_threads = num_threads;
             active_incomplete_threads = num_local_search_threads;
         }
 
@@ -69,7 +127,7 @@ namespace solve {
         uint num_brute_force_threads(0);
         if (pif.solver == solver::SolverType::BruteForce) {
             num_brute_force_threads = 1;
-            while (num_brute_force_threads*2 <= pif.threads) num_brute_force_threads *= 2;
+            while (num_brute_force_threads*2 <= num_threads) num_brute_force_threads *= 2;
             active_divided_threads = num_brute_force_threads;
         }
 
@@ -77,35 +135,43 @@ namespace solve {
         uint num_cdcl_threads(0);
         if (pif.solver == solver::SolverType::CDCL) {
             num_cdcl_threads = 1;
-            while (num_cdcl_threads*2 <= pif.threads) num_cdcl_threads *= 2;
-            active_incomplete_threads = num_cdcl_threads;
+            while (num_cdcl_threads*2 <= num_threads) num_cdcl_threads *= 2;
+            active_divided_threads = num_cdcl_threads;
         }
 
         // start solvers
         auto dpll_solvers = solver::dpll(expr, *this).divide(num_dpll_threads);
         auto brute_force_solvers = solver::brute_force(expr, *this).divide(num_brute_force_threads);
         auto cdcl_solvers = solver::cdcl(expr, *this).divide(num_cdcl_threads);
+        // give the restart policies to the cdcl threads in turn
+        for (std::size_t i(0); i < cdcl_solvers.size(); i++) {
+            cdcl_solvers[i].set_restarts(pif.restarts[i % pif.restarts.size()]);
+        }
         auto local_search_solver = solver::local_search(expr, *this);
-        for (std::size_t i(0); i < pif.threads; i++) {
-            if (num_dpll_threads > 0) {
-                threads.emplace_back(std::jthread(dpll_solvers[i]));
-                num_dpll_threads--;
-            } else if (num_local_search_threads > 0) {
-                threads.emplace_back(std::jthread(local_search_solver));
-                num_local_search_threads--;
-            } else if (num_brute_force_threads > 0) {
-                threads.emplace_back(std::jthread(brute_force_solvers[i]));
-                num_brute_force_threads--;
-            } else if (num_cdcl_threads > 0) {
-                threads.emplace_back(std::jthread(cdcl_solvers[i]));
-                num_cdcl_threads--;
-            } else break;
+        // solvers already started, or a sibling part, may finish the search
+        // while the rest start, so the lock is held to read it
+        {
+            std::scoped_lock lock(m);
+            for (std::size_t i(0); i < num_threads && !finished; i++) {
+                if (num_dpll_threads > 0) {
+                    threads.emplace_back(std::jthread(dpll_solvers[i]));
+                    num_dpll_threads--;
+                } else if (num_local_search_threads > 0) {
+                    threads.emplace_back(std::jthread(local_search_solver));
+                    num_local_search_threads--;
+                } else if (num_brute_force_threads > 0) {
+                    threads.emplace_back(std::jthread(brute_force_solvers[i]));
+                    num_brute_force_threads--;
+                } else if (num_cdcl_threads > 0) {
+                    threads.emplace_back(std::jthread(cdcl_solvers[i]));
+                    num_cdcl_threads--;
+                } else break;
+            }
         }
 
         // get current time
         std::chrono::steady_clock time;
         auto last_monitor_time = time.now();
-        auto start_time = time.now();
         uint mem_warn_count(0);
 
         // manage solvers periodically and upon finishing
@@ -121,7 +187,7 @@ namespace solve {
                 }
             );
             last_monitor_time = time.now();
-            if (time.now() - start_time >= pif.duration && !finished) {
+            if (time.now() >= deadline && !finished) {
                 status = Status::OutOfTime;
                 finished = true;
                 pif.message(1, "time limit reached");
@@ -171,15 +237,126 @@ namespace solve {
         if (status == Status::ThreadPanic) {
             throw std::runtime_error(err::thread_panic);
         }
+    }
 
-        // assign arbitrary values to any remaining variables
-        for (auto const& var : expr.variables()) {
-            if (!sol.map().contains(var)) {
-                sol.assign_variable(var, true);
+    // add the statistics of one part of a problem to those of the others
+    // Counts of work done are added together, and the average LBD is
+    // weighted by the clauses each part learned; any other value, such
+    // as the solver's name, is taken from the part. The elapsed time is
+    // set once all the parts have finished.
+    inline void add_stats(std::map<std::string, std::string>& total, const std::map<std::string, std::string>& part) {
+        static const std::set<std::string> counters{
+            "ASSIGNMENTS_CHECKED", "BLOCKED_RESTARTS", "CLAUSE_DB_REDUCTIONS", "CONFLICTS",
+            "DECISIONS", "DELETED_CLAUSES", "LEARNED_CLAUSES", "PROPAGATIONS", "REPHASES",
+            "RESTARTS", "WALKS", "WATCH_VISITS"
+        };
+        auto learned = [](const std::map<std::string, std::string>& stats) -> double {
+            auto it = stats.find("LEARNED_CLAUSES");
+            return it == stats.end() ? 0 : std::stod(it->second);
+        };
+        const double total_learned = learned(total);
+        const double part_learned = learned(part);
+        for (const auto& [key, val] : part) {
+            auto it = total.find(key);
+            if (it == total.end()) {
+                total.insert({key, val});
+            } else if (counters.contains(key)) {
+                it->second = std::to_string(std::stoull(it->second) + std::stoull(val));
+            } else if (key == "AVERAGE_LBD") {
+                it->second = std::to_string(total_learned + part_learned == 0 ? 0.0 :
+                    (std::stod(it->second) * total_learned + std::stod(val) * part_learned)
+                    / (total_learned + part_learned)
+                );
+            } else {
+                it->second = val;
             }
         }
+    }
 
-        return std::make_pair(status, sol);
+    // run the solvers on each independent part of an expression
+    // Each part gets its own orchestrator and an equal share of the
+    // threads, and as many parts run at once as there are shares. The
+    // values found for each part are copied into one solution; as soon
+    // as a part has none, or fails, the parts still running are
+    // cancelled. The statistics of the parts are combined.
+    void orchestrator::search_components(std::vector<cnf::component>& parts) {
+        pif.message(2, format("the problem splits into {} independent parts", parts.size()));
+        const auto start_time = std::chrono::steady_clock::now();
+        const std::size_t num_running = std::max<std::size_t>(1, std::min<std::size_t>(parts.size(), num_threads));
+        const uint share = std::max<uint>(1, num_threads / num_running);
+        std::vector<std::unique_ptr<orchestrator>> children(parts.size());
+        std::size_t next(0);
+        std::exception_ptr error;
+        sol.set_valid(true);
+
+        auto worker = [&]() {
+            while (true) {
+                std::size_t i;
+                {
+                    std::scoped_lock lock(m);
+                    if (next == parts.size() || finished) {
+                        return;
+                    }
+                    i = next++;
+                    children[i].reset(new orchestrator(pif, share, deadline));
+                }
+                orchestrator& child = *children[i];
+                try {
+                    child.search(parts[i].expr);
+                } catch (...) {
+                    std::scoped_lock lock(m);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    child.status = Status::ThreadPanic;
+                }
+                std::scoped_lock lock(m);
+                if (!finished) {
+                    if (child.status != Status::Success || !child.sol.is_valid()) {
+                        // the whole problem has no solution, or none was found
+                        sol.set_valid(false);
+                        add_stats(sol.stats(), child.sol.stats());
+                        status = child.status;
+                        finished = true;
+                        for (auto& other : children) {
+                            if (other) {
+                                other->cancel();
+                            }
+                        }
+                    } else {
+                        const std::vector<cnf::variable>& names = parts[i].variables;
+                        for (cnf::variable var(1); static_cast<std::size_t>(var) < names.size(); var++) {
+                            if (child.sol.assignment().is_assigned(var)) {
+                                sol.assign_variable(names[var], child.sol.assignment().is_true(var));
+                            }
+                        }
+                        add_stats(sol.stats(), child.sol.stats());
+                    }
+                }
+                children[i].reset();
+            }
+        };
+        std::vector<std::jthread> workers;
+        for (std::size_t i(0); i < num_running; i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        // the parts may run at once, so their elapsed times are not added
+        const std::chrono::duration<double> elapsed_time = std::chrono::steady_clock::now() - start_time;
+        sol.stats()["ELAPSED_TIME_SECONDS"] = std::to_string(elapsed_time.count());
+        sol.stats().insert({"COMPONENTS", std::to_string(parts.size())});
+    }
+
+    // stop the solvers early, without a result
+    void orchestrator::cancel() {
+        std::scoped_lock lock(m);
+        finished = true;
+        finish.notify_all();
     }
 
     // report solution
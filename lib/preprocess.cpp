@@ -0,0 +1,925 @@
+// preprocess.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "preprocess.hpp"
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace preprocess {
+
+    // will need abs frequently
+    using std::abs;
+    using cnf::lit_index;
+    using clock = std::chrono::steady_clock;
+
+    // variables with more occurrences than this are not eliminated,
+    // unless all of them have the same sign
+    constexpr std::size_t max_occurrences = 64;
+
+    // a variable is not eliminated if a resolvent would be longer than this
+    constexpr std::size_t max_resolvent_size = 20;
+
+    // clauses are not compared against variables with more occurrences
+    // than this when looking for subsumed clauses
+    constexpr std::size_t max_subsumption_occurrences = 1000;
+
+    // the number of clauses saved by replacing the clauses made of each of
+    // a set of literals and each of a set of clause remainders with a new
+    // variable
+    inline long long bva_reduction(std::size_t lits, std::size_t remainders) {
+        return static_cast<long long>(lits * remainders) - lits - remainders;
+    }
+
+    // hyper-binary resolvents are added for at most one clause in this many
+    constexpr std::size_t hyper_binary_ratio = 8;
+
+    // the clock is read once every this many limit checks
+    constexpr std::size_t check_interval = 64;
+
+    // order literals by their index, so each variable's literals are adjacent
+    inline bool by_index(literal a, literal b) {
+        return lit_index(a) < lit_index(b);
+    }
+
+    // give the signature of a clause
+    inline std::uint64_t signature(const std::vector<literal>& lits) {
+        std::uint64_t sig(0);
+        for (const literal& lit : lits) {
+            sig |= 1ull << (abs(lit) % 64);
+        }
+        return sig;
+    }
+
+    // Given two clauses sorted by lit_index that both contain var, resolve
+    // writes their resolvent on var, sorted by lit_index, and returns false
+    // if the resolvent is a tautology.
+    inline bool resolve(
+        const std::vector<literal>& a,
+        const std::vector<literal>& b,
+        variable var,
+        std::vector<literal>& out
+    ) {
+        out.clear();
+        std::size_t i(0);
+        std::size_t j(0);
+        while (i < a.size() || j < b.size()) {
+            literal lit;
+            if (j == b.size() || (i < a.size() && by_index(a[i], b[j]))) {
+                lit = a[i++];
+            } else if (i == a.size() || by_index(b[j], a[i])) {
+                lit = b[j++];
+            } else {
+                // both clauses hold the same literal
+                lit = a[i++];
+                j++;
+            }
+            if (abs(lit) == var) {
+                continue;
+            }
+            if (!out.empty() && out.back() == -lit) {
+                return false;
+            }
+            out.push_back(lit);
+        }
+        return true;
+    }
+
+    // time limit constructor
+    preprocessor::preprocessor(clock::duration time_limit):
+        limit(time_limit),
+        checks(0),
+        timed_out(false),
+        unsat(false),
+        ran(false),
+        num_fixed(0),
+        num_eliminated(0),
+        num_subsumed(0),
+        num_strengthened(0),
+        num_substituted(0),
+        num_failed(0),
+        num_hyper_binary(0),
+        num_blocked(0),
+        num_added_variables(0),
+        seconds(0)
+    {}
+
+    // simplify an expression in place
+    // the expression must not have been simplified by a solver
+    void preprocessor::operator()(cnf::cnf_expr& expr) {
+        const clock::time_point start = clock::now();
+        deadline = start + limit;
+        ran = true;
+        load(expr);
+        propagate();
+        // substitution and probing may use half the time
+        deadline = start + limit / 2;
+        if (!unsat) {
+            substitute();
+        }
+        if (!unsat && !timed_out) {
+            probe();
+        }
+        deadline = start + limit;
+        timed_out = false;
+        if (!unsat) {
+            block();
+        }
+        while (!unsat) {
+            propagate();
+            subsume();
+            if (unsat || timed_out || !eliminate()) {
+                break;
+            }
+        }
+        if (!unsat && !timed_out) {
+            add_variables();
+            subsume();
+        }
+        store_back(expr);
+        // only the extension stack is needed from here on
+        std::vector<entry>().swap(store);
+        std::vector<std::vector<std::uint32_t>>().swap(occurs);
+        seconds = std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    // give values to removed variables in a solution of the simplified
+    // expression
+    // the stack is visited in reverse, so every variable in a clause is
+    // given a value before the clause is checked
+    void preprocessor::extend(sol::solution& sol) const {
+        std::size_t pos(extension.size());
+        while (pos > 0) {
+            const std::size_t size = extension[pos - 1];
+            const std::size_t first = pos - 1 - size;
+            bool satisfied(false);
+            for (std::size_t i(first); i < first + size && !satisfied; i++) {
+                satisfied = sol.assignment().is_true(extension[i]);
+            }
+            if (!satisfied) {
+                const literal witness = extension[first];
+                sol.reassign_variable(abs(witness), witness > 0);
+            }
+            pos = first;
+        }
+    }
+
+    // add the reductions made to a set of statistics
+    void preprocessor::report(std::map<std::string, std::string>& stats) const {
+        if (!ran) {
+            return;
+        }
+        stats.insert({"FIXED_VARIABLES", std::to_string(num_fixed)});
+        stats.insert({"ELIMINATED_VARIABLES", std::to_string(num_eliminated)});
+        stats.insert({"SUBSUMED_CLAUSES", std::to_string(num_subsumed)});
+        stats.insert({"STRENGTHENED_CLAUSES", std::to_string(num_strengthened)});
+        stats.insert({"SUBSTITUTED_VARIABLES", std::to_string(num_substituted)});
+        stats.insert({"FAILED_LITERALS", std::to_string(num_failed)});
+        stats.insert({"HYPER_BINARY_RESOLVENTS", std::to_string(num_hyper_binary)});
+        stats.insert({"BLOCKED_CLAUSES", std::to_string(num_blocked)});
+        stats.insert({"ADDED_VARIABLES", std::to_string(num_added_variables)});
+        stats.insert({"PREPROCESS_TIME_SECONDS", std::to_string(seconds)});
+    }
+
+    // give the number of variables removed
+    std::size_t preprocessor::num_removed_variables() const {
+        return num_fixed + num_eliminated + num_substituted;
+    }
+
+    // copy the clauses of an expression into the store
+    void preprocessor::load(const cnf::cnf_expr& expr) {
+        const variable max_var = expr.get_max_var();
+        occurs.resize(2 * (static_cast<std::size_t>(max_var) + 1));
+        probed = cnf::assignment(max_var);
+        eliminated.assign(max_var + 1, false);
+        touched.assign(max_var + 1, false);
+        store.reserve(expr.get_num_clauses());
+        for (const cnf::clause& cl : expr.get_clauses()) {
+            const cnf::lit_span lits = expr.get_clause(cl);
+            std::vector<literal> sorted(lits.begin(), lits.end());
+            std::sort(sorted.begin(), sorted.end(), by_index);
+            add(std::move(sorted));
+        }
+    }
+
+    // put the clauses left back into the expression
+    void preprocessor::store_back(cnf::cnf_expr& expr) const {
+        expr.clear_clauses();
+        // variables added by preprocessing follow those of the expression
+        while (static_cast<std::size_t>(expr.get_max_var()) + 1 < eliminated.size()) {
+            expr.new_variable();
+        }
+        if (unsat) {
+            // a single empty clause shows the expression is unsatisfiable
+            expr.add_clause(cnf::lit_span());
+            return;
+        }
+        for (const entry& e : store) {
+            if (!e.removed) {
+                expr.add_clause(e.lits);
+            }
+        }
+        for (variable var(1); static_cast<std::size_t>(var) < eliminated.size(); var++) {
+            if (eliminated[var]) {
+                expr.remove_variable(var);
+            }
+        }
+    }
+
+    // check whether the time limit was reached
+    bool preprocessor::out_of_time() {
+        if (!timed_out && ++checks % check_interval == 0 && clock::now() >= deadline) {
+            timed_out = true;
+        }
+        return timed_out;
+    }
+
+    // add a clause to the store; its literals must be sorted
+    void preprocessor::add(std::vector<literal>&& lits) {
+        const std::uint32_t idx = store.size();
+        for (const literal& lit : lits) {
+            occurs[lit_index(lit)].push_back(idx);
+            touched[abs(lit)] = true;
+        }
+        if (lits.empty()) {
+            unsat = true;
+        } else if (lits.size() == 1) {
+            unit_queue.push_back(idx);
+        }
+        const std::uint64_t sig = signature(lits);
+        store.push_back({std::move(lits), sig, false, true});
+        subsumption_queue.push_back(idx);
+    }
+
+    // remove a clause from the store
+    // it stays in the occurrence lists until they are cleaned
+    void preprocessor::remove(std::uint32_t idx) {
+        entry& e = store[idx];
+        for (const literal& lit : e.lits) {
+            touched[abs(lit)] = true;
+        }
+        e.removed = true;
+        std::vector<literal>().swap(e.lits);
+    }
+
+    // remove a literal from a clause in the store
+    void preprocessor::strengthen(std::uint32_t idx, literal lit) {
+        entry& e = store[idx];
+        e.lits.erase(std::find(e.lits.begin(), e.lits.end(), lit));
+        e.signature = signature(e.lits);
+        std::erase(occurs[lit_index(lit)], idx);
+        touched[abs(lit)] = true;
+        num_strengthened++;
+        if (e.lits.empty()) {
+            unsat = true;
+        } else if (e.lits.size() == 1) {
+            unit_queue.push_back(idx);
+        }
+        // a shorter clause may subsume more
+        if (!e.queued) {
+            e.queued = true;
+            subsumption_queue.push_back(idx);
+        }
+    }
+
+    // push a removed clause onto the extension stack
+    void preprocessor::push_extension(literal witness, const std::vector<literal>& lits) {
+        extension.push_back(witness);
+        for (const literal& lit : lits) {
+            if (lit != witness) {
+                extension.push_back(lit);
+            }
+        }
+        extension.push_back(lits.size());
+    }
+
+    // remove the removed clauses from the occurrence lists of a literal
+    std::vector<std::uint32_t>& preprocessor::clean(literal lit) {
+        std::vector<std::uint32_t>& list = occurs[lit_index(lit)];
+        std::erase_if(list, [&](std::uint32_t idx) { return store[idx].removed; });
+        return list;
+    }
+
+    // propagate the queued unit clauses
+    // each fixed variable is recorded on the extension stack as a unit
+    // clause, and its clauses are removed or strengthened
+    void preprocessor::propagate() {
+        while (!unit_queue.empty() && !unsat) {
+            const std::uint32_t idx = unit_queue.back();
+            unit_queue.pop_back();
+            if (store[idx].removed || store[idx].lits.size() != 1) {
+                continue;
+            }
+            const literal lit = store[idx].lits[0];
+            eliminated[abs(lit)] = true;
+            num_fixed++;
+            push_extension(lit, store[idx].lits);
+            for (const std::uint32_t& cl : clean(lit)) {
+                remove(cl);
+            }
+            occurs[lit_index(lit)].clear();
+            // taken out first, so strengthening does not search the list
+            const std::vector<std::uint32_t> falsified = std::move(clean(-lit));
+            occurs[lit_index(-lit)].clear();
+            for (const std::uint32_t& cl : falsified) {
+                strengthen(cl, -lit);
+                if (unsat) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // find the strongly connected components of the binary implication
+    // graph with Tarjan's algorithm, and replace every variable in one with
+    // the component's smallest variable
+    // a component holding both signs of a variable is a contradiction
+    void preprocessor::substitute() {
+        const std::size_t nodes = occurs.size();
+        // the literals implied by each literal through a binary clause
+        std::vector<std::vector<literal>> implies(nodes);
+        for (const entry& e : store) {
+            if (!e.removed && e.lits.size() == 2) {
+                implies[lit_index(-e.lits[0])].push_back(e.lits[1]);
+                implies[lit_index(-e.lits[1])].push_back(e.lits[0]);
+            }
+        }
+        constexpr std::uint32_t unvisited = std::numeric_limits<std::uint32_t>::max();
+        // visit order and lowest reachable visit order of each literal
+        std::vector<std::uint32_t> order(nodes, unvisited);
+        std::vector<std::uint32_t> low(nodes, 0);
+        // the component of each literal, numbered from one once complete
+        std::vector<std::uint32_t> component(nodes, 0);
+        // the representative of each literal, or zero if it has none
+        std::vector<literal> representative(nodes, 0);
+        std::vector<literal> stack;
+        // the literals being visited, with the next implication to follow
+        std::vector<std::pair<literal, std::size_t>> calls;
+        std::uint32_t visited(0);
+        std::uint32_t components(0);
+        auto visit = [&](literal lit) {
+            order[lit_index(lit)] = low[lit_index(lit)] = visited++;
+            stack.push_back(lit);
+            calls.push_back({lit, 0});
+        };
+        for (variable var(1); static_cast<std::size_t>(var) < eliminated.size() && !unsat; var++) {
+            if (eliminated[var] || out_of_time()) {
+                continue;
+            }
+            for (const literal root : {var, -var}) {
+                if (order[lit_index(root)] != unvisited) {
+                    continue;
+                }
+                visit(root);
+                while (!calls.empty() && !unsat) {
+                    const literal lit = calls.back().first;
+                    const std::size_t idx = lit_index(lit);
+                    if (calls.back().second < implies[idx].size()) {
+                        const literal next = implies[idx][calls.back().second++];
+                        if (order[lit_index(next)] == unvisited) {
+                            visit(next);
+                        } else if (component[lit_index(next)] == 0) {
+                            // still on the stack
+                            low[idx] = std::min(low[idx], order[lit_index(next)]);
+                        }
+                        continue;
+                    }
+                    calls.pop_back();
+                    if (!calls.empty()) {
+                        const std::size_t parent = lit_index(calls.back().first);
+                        low[parent] = std::min(low[parent], low[idx]);
+                    }
+                    if (low[idx] != order[idx]) {
+                        continue;
+                    }
+                    // lit is the root of a component; take it off the stack
+                    std::size_t first(stack.size());
+                    do {
+                        first--;
+                    } while (stack[first] != lit);
+                    components++;
+                    literal best(lit);
+                    for (std::size_t i(first); i < stack.size(); i++) {
+                        component[lit_index(stack[i])] = components;
+                        if (abs(stack[i]) < abs(best)) {
+                            best = stack[i];
+                        }
+                    }
+                    for (std::size_t i(first); i < stack.size(); i++) {
+                        if (component[lit_index(-stack[i])] == components) {
+                            unsat = true;
+                        }
+                        representative[lit_index(stack[i])] = best;
+                    }
+                    stack.resize(first);
+                }
+            }
+        }
+        for (variable var(1); static_cast<std::size_t>(var) < eliminated.size() && !unsat; var++) {
+            const literal rep = representative[lit_index(var)];
+            if (!eliminated[var] && rep != 0 && rep != var) {
+                substitute_variable(var, rep);
+            }
+        }
+    }
+
+    // replace a variable with an equivalent literal
+    // the equivalence is recorded on the extension stack as two clauses
+    void preprocessor::substitute_variable(variable var, literal rep) {
+        push_extension(-var, {-var, rep});
+        push_extension(var, {var, -rep});
+        for (const literal lit : {var, -var}) {
+            const literal replacement = lit > 0 ? rep : -rep;
+            const std::vector<std::uint32_t> list = clean(lit);
+            for (const std::uint32_t& cl : list) {
+                std::vector<literal> lits = store[cl].lits;
+                *std::find(lits.begin(), lits.end(), lit) = replacement;
+                std::sort(lits.begin(), lits.end(), by_index);
+                lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+                bool tautology(false);
+                for (std::size_t i(1); i < lits.size() && !tautology; i++) {
+                    tautology = lits[i] == -lits[i - 1];
+                }
+                remove(cl);
+                if (!tautology) {
+                    add(std::move(lits));
+                }
+            }
+            occurs[lit_index(lit)].clear();
+        }
+        eliminated[var] = true;
+        num_substituted++;
+    }
+
+    // probe both signs of every variable in a binary clause
+    // a failed literal gives a unit clause of its negation, as does a
+    // literal implied by both signs
+    void preprocessor::probe() {
+        const std::size_t hyper_binary_limit = store.size() / hyper_binary_ratio;
+        std::vector<literal> trail;
+        std::vector<literal> hyper;
+        std::vector<literal> implied;
+        std::vector<bool> marks(occurs.size(), false);
+        // add the hyper-binary resolvents found by probing a literal
+        auto add_hyper = [&](literal lit) {
+            for (const literal& other : hyper) {
+                if (num_hyper_binary >= hyper_binary_limit) {
+                    break;
+                }
+                std::vector<literal> lits{-lit, other};
+                std::sort(lits.begin(), lits.end(), by_index);
+                add(std::move(lits));
+                num_hyper_binary++;
+            }
+        };
+        for (variable var(1); static_cast<std::size_t>(var) < eliminated.size(); var++) {
+            if (unsat || out_of_time()) {
+                break;
+            }
+            if (eliminated[var]) {
+                continue;
+            }
+            bool binary(false);
+            for (const literal lit : {var, -var}) {
+                for (const std::uint32_t& cl : clean(lit)) {
+                    binary = binary || store[cl].lits.size() == 2;
+                }
+            }
+            if (!binary) {
+                continue;
+            }
+            if (!probe_literal(var, trail, hyper)) {
+                add({-var});
+                num_failed++;
+                propagate();
+                continue;
+            }
+            add_hyper(var);
+            implied = trail;
+            if (!probe_literal(-var, trail, hyper)) {
+                add({var});
+                num_failed++;
+                propagate();
+                continue;
+            }
+            add_hyper(-var);
+            // a literal implied by both signs holds
+            for (const literal& lit : implied) {
+                marks[lit_index(lit)] = true;
+            }
+            for (const literal& lit : trail) {
+                if (marks[lit_index(lit)]) {
+                    add({lit});
+                }
+            }
+            for (const literal& lit : implied) {
+                marks[lit_index(lit)] = false;
+            }
+            propagate();
+        }
+    }
+
+    // Given a literal, probe_literal assumes it and propagates it through
+    // the clauses, giving every literal implied in order, and those implied
+    // by clauses of more than two literals. It returns false if a clause
+    // is falsified.
+    bool preprocessor::probe_literal(literal lit, std::vector<literal>& trail, std::vector<literal>& hyper) {
+        trail.assign(1, lit);
+        hyper.clear();
+        probed.assign(lit);
+        bool conflict(false);
+        for (std::size_t i(0); i < trail.size() && !conflict; i++) {
+            for (const std::uint32_t& cl : occurs[lit_index(-trail[i])]) {
+                const entry& e = store[cl];
+                if (e.removed) {
+                    continue;
+                }
+                literal unit(0);
+                std::size_t open(0);
+                bool satisfied(false);
+                for (const literal& other : e.lits) {
+                    if (probed.is_true(other)) {
+                        satisfied = true;
+                        break;
+                    } else if (!probed.is_true(-other)) {
+                        unit = other;
+                        open++;
+                    }
+                }
+                if (satisfied || open > 1) {
+                    continue;
+                } else if (open == 0) {
+                    conflict = true;
+                    break;
+                }
+                probed.assign(unit);
+                trail.push_back(unit);
+                if (e.lits.size() > 2) {
+                    hyper.push_back(unit);
+                }
+            }
+        }
+        for (const literal& assumed : trail) {
+            probed.unassign(abs(assumed));
+        }
+        return !conflict;
+    }
+
+    // remove every blocked clause
+    // a clause is blocked on one of its literals if every resolvent on
+    // that literal is a tautology; removing it keeps the expression
+    // satisfiable, and a model is repaired by making the literal true
+    void preprocessor::block() {
+        std::vector<bool> marks(occurs.size(), false);
+        for (std::uint32_t idx(0); idx < store.size(); idx++) {
+            if (unsat || out_of_time()) {
+                break;
+            }
+            if (store[idx].removed) {
+                continue;
+            }
+            const entry& e = store[idx];
+            for (const literal& lit : e.lits) {
+                marks[lit_index(lit)] = true;
+            }
+            literal blocking(0);
+            for (const literal& lit : e.lits) {
+                const std::vector<std::uint32_t>& others = clean(-lit);
+                if (others.size() > max_occurrences) {
+                    continue;
+                }
+                // each resolvent is a tautology if the other clause holds
+                // the negation of another literal of this one
+                const bool blocked = std::ranges::all_of(others, [&](std::uint32_t other) {
+                    return std::ranges::any_of(store[other].lits, [&](literal x) {
+                        return x != -lit && marks[lit_index(-x)];
+                    });
+                });
+                if (blocked) {
+                    blocking = lit;
+                    break;
+                }
+            }
+            for (const literal& lit : e.lits) {
+                marks[lit_index(lit)] = false;
+            }
+            if (blocking != 0) {
+                push_extension(blocking, e.lits);
+                remove(idx);
+                num_blocked++;
+            }
+        }
+    }
+
+    // introduce a variable after those in the store
+    variable preprocessor::new_variable() {
+        if (eliminated.size() > static_cast<std::size_t>(std::numeric_limits<variable>::max())) {
+            throw std::length_error(err::expression_size);
+        }
+        const variable var = eliminated.size();
+        occurs.resize(2 * (static_cast<std::size_t>(var) + 1));
+        eliminated.push_back(false);
+        touched.push_back(false);
+        return var;
+    }
+
+    // try bounded variable addition on every literal, most frequent first
+    void preprocessor::add_variables() {
+        std::vector<std::pair<std::size_t, literal>> candidates;
+        for (variable var(1); static_cast<std::size_t>(var) < eliminated.size(); var++) {
+            for (const literal lit : {var, -var}) {
+                if (!eliminated[var] && clean(lit).size() >= 3) {
+                    candidates.push_back({occurs[lit_index(lit)].size(), lit});
+                }
+            }
+        }
+        std::sort(candidates.rbegin(), candidates.rend());
+        for (const auto& [count, lit] : candidates) {
+            while (!unsat && !out_of_time() && add_variable(lit)) {}
+        }
+    }
+
+    // Given a literal, add_variable looks for other literals that appear
+    // with the same remainders: clauses that differ from one holding the
+    // literal only in that literal. Literals are added greedily while the
+    // saving grows. If the clauses made of each found literal and each
+    // shared remainder outnumber the literals and remainders together,
+    // they are replaced by a clause joining each literal to a new
+    // variable, and a clause joining each remainder to its negation.
+    // Resolving on the new variable gives back the replaced clauses, so a
+    // model of the result is a model of the original after dropping the
+    // variable. It returns whether a variable was added.
+    bool preprocessor::add_variable(literal lit) {
+        // the literals found, and for each remainder the clause of each literal
+        std::vector<literal> found{lit};
+        std::vector<std::vector<std::uint32_t>> matches;
+        for (const std::uint32_t& cl : clean(lit)) {
+            if (store[cl].lits.size() >= 2) {
+                matches.push_back({cl});
+            }
+        }
+        std::vector<bool> marks(occurs.size(), false);
+        // another literal, the remainder it shares, and its clause
+        std::vector<std::tuple<literal, std::size_t, std::uint32_t>> pairs;
+        while (true) {
+            pairs.clear();
+            for (std::size_t k(0); k < matches.size(); k++) {
+                const entry& e = store[matches[k][0]];
+                literal rarest(0);
+                for (const literal& other : e.lits) {
+                    if (other != lit) {
+                        marks[lit_index(other)] = true;
+                        if (rarest == 0 || occurs[lit_index(other)].size() < occurs[lit_index(rarest)].size()) {
+                            rarest = other;
+                        }
+                    }
+                }
+                if (occurs[lit_index(rarest)].size() <= max_subsumption_occurrences) {
+                    for (const std::uint32_t& cl : occurs[lit_index(rarest)]) {
+                        const entry& candidate = store[cl];
+                        if (candidate.removed || candidate.lits.size() != e.lits.size()) {
+                            continue;
+                        }
+                        // the clause must hold the remainder and one other literal
+                        literal extra(0);
+                        std::size_t unmarked(0);
+                        for (const literal& other : candidate.lits) {
+                            if (!marks[lit_index(other)]) {
+                                extra = other;
+                                unmarked++;
+                            }
+                        }
+                        if (unmarked == 1 && abs(extra) != abs(lit) && std::ranges::find(found, extra) == found.end()) {
+                            pairs.push_back({extra, k, cl});
+                        }
+                    }
+                }
+                for (const literal& other : e.lits) {
+                    marks[lit_index(other)] = false;
+                }
+            }
+            if (pairs.empty()) {
+                break;
+            }
+            // the literal sharing the most remainders
+            std::sort(pairs.begin(), pairs.end());
+            literal best(0);
+            std::size_t best_count(0);
+            for (std::size_t i(0), j(0); i < pairs.size(); i = j) {
+                while (j < pairs.size() && std::get<0>(pairs[j]) == std::get<0>(pairs[i])) {
+                    j++;
+                }
+                if (j - i > best_count) {
+                    best = std::get<0>(pairs[i]);
+                    best_count = j - i;
+                }
+            }
+            if (bva_reduction(found.size() + 1, best_count) <= bva_reduction(found.size(), matches.size())) {
+                break;
+            }
+            // keep the remainders the literal shares, once each
+            std::vector<std::vector<std::uint32_t>> kept;
+            std::size_t last_k(matches.size());
+            for (const auto& [extra, k, cl] : pairs) {
+                if (extra == best && k != last_k) {
+                    kept.push_back(std::move(matches[k]));
+                    kept.back().push_back(cl);
+                    last_k = k;
+                }
+            }
+            matches = std::move(kept);
+            found.push_back(best);
+        }
+        if (found.size() < 2 || bva_reduction(found.size(), matches.size()) <= 0) {
+            return false;
+        }
+
+        const variable var = new_variable();
+        std::vector<std::vector<literal>> replacements;
+        for (const literal& other : found) {
+            std::vector<literal> lits{other, var};
+            std::sort(lits.begin(), lits.end(), by_index);
+            replacements.push_back(std::move(lits));
+        }
+        for (const std::vector<std::uint32_t>& clauses : matches) {
+            std::vector<literal> lits;
+            for (const literal& other : store[clauses[0]].lits) {
+                if (other != lit) {
+                    lits.push_back(other);
+                }
+            }
+            lits.push_back(-var);
+            std::sort(lits.begin(), lits.end(), by_index);
+            replacements.push_back(std::move(lits));
+            for (const std::uint32_t& cl : clauses) {
+                remove(cl);
+            }
+        }
+        for (std::vector<literal>& lits : replacements) {
+            add(std::move(lits));
+        }
+        num_added_variables++;
+        return true;
+    }
+
+    // Given two clauses, subsumes returns zero if the first subsumes the
+    // second, or a literal of the first whose negation can be removed
+    // from the second by self-subsuming resolution. It returns nothing if
+    // the clauses are unrelated.
+    std::optional<literal> preprocessor::subsumes(const entry& a, const entry& b) const {
+        if (a.lits.size() > b.lits.size() || (a.signature & ~b.signature) != 0) {
+            return std::nullopt;
+        }
+        literal flipped(0);
+        std::size_t j(0);
+        for (const literal& lit : a.lits) {
+            // both are sorted by variable
+            while (j < b.lits.size() && abs(b.lits[j]) < abs(lit)) {
+                j++;
+            }
+            if (j == b.lits.size() || abs(b.lits[j]) != abs(lit)) {
+                return std::nullopt;
+            }
+            if (b.lits[j] != lit) {
+                if (flipped != 0) {
+                    return std::nullopt;
+                }
+                flipped = lit;
+            }
+            j++;
+        }
+        return flipped;
+    }
+
+    // remove and strengthen clauses using the queued clauses
+    // each queued clause is compared against the clauses of its least
+    // frequent variable, in both signs
+    void preprocessor::subsume() {
+        std::vector<std::uint32_t> candidates;
+        while (!subsumption_queue.empty() && !unsat && !out_of_time()) {
+            propagate();
+            const std::uint32_t idx = subsumption_queue.back();
+            subsumption_queue.pop_back();
+            store[idx].queued = false;
+            if (store[idx].removed || unsat) {
+                continue;
+            }
+            variable best(0);
+            std::size_t best_size(0);
+            for (const literal& lit : store[idx].lits) {
+                const std::size_t size = occurs[lit_index(lit)].size() + occurs[lit_index(-lit)].size();
+                if (best == 0 || size < best_size) {
+                    best = abs(lit);
+                    best_size = size;
+                }
+            }
+            if (best_size > max_subsumption_occurrences) {
+                continue;
+            }
+            candidates = clean(best);
+            const std::vector<std::uint32_t>& negative = clean(-best);
+            candidates.insert(candidates.end(), negative.begin(), negative.end());
+            for (const std::uint32_t& other : candidates) {
+                if (other == idx || store[other].removed) {
+                    continue;
+                }
+                const std::optional<literal> result = subsumes(store[idx], store[other]);
+                if (!result) {
+                    continue;
+                } else if (*result == 0) {
+                    remove(other);
+                    num_subsumed++;
+                } else {
+                    strengthen(other, -*result);
+                    if (unsat) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    // try to eliminate every touched variable, cheapest first
+    // returns whether any variable was eliminated
+    bool preprocessor::eliminate() {
+        std::vector<std::pair<std::size_t, variable>> candidates;
+        for (variable var(1); static_cast<std::size_t>(var) < touched.size(); var++) {
+            if (touched[var] && !eliminated[var]) {
+                touched[var] = false;
+                candidates.push_back({occurs[lit_index(var)].size() * occurs[lit_index(-var)].size(), var});
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        bool progress(false);
+        for (const auto& [cost, var] : candidates) {
+            if (unsat || out_of_time()) {
+                break;
+            }
+            if (!eliminated[var] && eliminate_variable(var)) {
+                progress = true;
+                propagate();
+            }
+        }
+        return progress;
+    }
+
+    // try to eliminate a variable
+    // the variable is eliminated if its clauses can be replaced by no more
+    // non-tautological resolvents, none of them too long
+    bool preprocessor::eliminate_variable(variable var) {
+        const std::vector<std::uint32_t> positive = clean(var);
+        const std::vector<std::uint32_t> negative = clean(-var);
+        if (positive.empty() && negative.empty()) {
+            return false;
+        }
+        if (!positive.empty() && !negative.empty() && positive.size() + negative.size() > max_occurrences) {
+            return false;
+        }
+        std::vector<std::vector<literal>> resolvents;
+        std::vector<literal> resolvent;
+        for (const std::uint32_t& p : positive) {
+            for (const std::uint32_t& n : negative) {
+                if (!resolve(store[p].lits, store[n].lits, var, resolvent)) {
+                    continue;
+                }
+                if (
+                    resolvent.size() > max_resolvent_size ||
+                    resolvents.size() == positive.size() + negative.size()
+                ) {
+                    return false;
+                }
+                resolvents.push_back(resolvent);
+            }
+        }
+
+        // record the clauses of the rarer sign, then a default value
+        // for the variable, which those clauses override when needed
+        if (positive.size() > negative.size()) {
+            for (const std::uint32_t& n : negative) {
+                push_extension(-var, store[n].lits);
+            }
+            push_extension(var, {var});
+        } else {
+            for (const std::uint32_t& p : positive) {
+                push_extension(var, store[p].lits);
+            }
+            push_extension(-var, {-var});
+        }
+        for (const std::uint32_t& cl : positive) {
+            remove(cl);
+        }
+        for (const std::uint32_t& cl : negative) {
+            remove(cl);
+        }
+        occurs[lit_index(var)].clear();
+        occurs[lit_index(-var)].clear();
+        eliminated[var] = true;
+        num_eliminated++;
+        for (std::vector<literal>& lits : resolvents) {
+            add(std::move(lits));
+        }
+        return true;
+    }
+
+}
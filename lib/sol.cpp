@@ -10,24 +10,49 @@ namespace sol {
     using std::abs;
 
     // input stream constructor
-    solution::solution(std::istream& istr) {
+    solution::solution(std::istream& istr): num_assigned(0) {
         io::extract_solution(*this, istr);
     }
 
     // assign a variable
     bool solution::assign_variable(variable var, bool val) {
-        return variables.insert(std::pair{var, val}).second;
+        if (variables.is_assigned(var)) {
+            return false;
+        }
+        variables.assign(val ? var : -var);
+        num_assigned++;
+        return true;
     }
 
     // unassign a variable
     bool solution::unassign_variable(variable var) {
-        return variables.erase(var) == 1;
+        if (!variables.is_assigned(var)) {
+            return false;
+        }
+        variables.unassign(var);
+        num_assigned--;
+        return true;
     }
 
     // reassign a variable
     void solution::reassign_variable(variable var, bool val) {
-        solution::unassign_variable(var);
-        solution::assign_variable(var, val);
+        if (!variables.is_assigned(var)) {
+            num_assigned++;
+        }
+        variables.assign(val ? var : -var);
+    }
+
+    // negate the value of an assigned variable
+    void solution::flip_variable(variable var) {
+        variables.flip(var);
+    }
+
+    // remove every variable above the given one
+    void solution::truncate(variable var) {
+        for (variable extra(var + 1); extra <= variables.get_max_var(); extra++) {
+            unassign_variable(extra);
+        }
+        max_var = var;
     }
 
     // set status flag
@@ -42,11 +67,11 @@ namespace sol {
 
     // give the number of assigned variables
     std::size_t solution::size() const {
-        return variables.size();
+        return num_assigned;
     }
 
     // provide variable assignments
-    const std::map<variable, bool>& solution::map() const {
+    const cnf::assignment& solution::assignment() const {
         return variables;
     }
 
@@ -101,8 +126,10 @@ namespace sol {
         }
         // print variable lines
         if (sol.valid) {
-            for (const auto& [var, val] : sol.variables) {
-                ostr << std::format("v {}\n", val ? var : -var);
+            for (variable var(1); var <= sol.variables.get_max_var(); var++) {
+                if (sol.variables.is_assigned(var)) {
+                    ostr << std::format("v {}\n", sol.variables.is_true(var) ? var : -var);
+                }
             }
         }
         ostr.flush();
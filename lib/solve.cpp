@@ -4,23 +4,60 @@
 
 #include "solve.hpp"
 #include "solver.hpp"
+#include "preprocess.hpp"
+#include "symmetry.hpp"
 
 extern volatile std::sig_atomic_t sig;
 
 namespace solve {
 
-    // solve the problem
-    int run_portfolio(const program_interface& pif, std::istream& istr, std::ostream& ostr) {
+    // check for an interrupt received before solving
+    inline bool interrupted(const program_interface& pif) {
         if (sig != 0) {
             if (pif.verbosity > 0) {
                 (std::cout << "\nc interrupt signal received\n").flush();
             }
-            return 2;
+            return true;
+        }
+        return false;
+    }
+
+    // solve a parsed problem
+    inline int solve_problem(const program_interface& pif, cnf::cnf_expr& expr, std::ostream& ostr) {
+        if (expr.get_max_var() > expr.get_max_input_var()) {
+            pif.message(2, format(
+                "the formula was encoded with {} additional variables",
+                expr.get_max_var() - expr.get_max_input_var()
+            ));
+        }
+        // simplify the problem within its own time limit
+        const auto preprocess_start = std::chrono::steady_clock::now();
+        preprocess::preprocessor pre(pif.preprocess_time);
+        if (pif.preprocess) {
+            const std::size_t clauses = expr.get_num_clauses();
+            pre(expr);
+            pif.message(2, format(
+                "preprocessing removed {} variables, leaving {} of {} clauses",
+                pre.num_removed_variables(), expr.get_num_clauses(), clauses
+            ));
+        }
+        // break symmetries of the simplified problem within what is left
+        // of the same limit
+        symmetry::breaker sym(std::max<std::chrono::steady_clock::duration>(
+            pif.preprocess_time - (std::chrono::steady_clock::now() - preprocess_start),
+            std::chrono::steady_clock::duration::zero()
+        ));
+        if (pif.symmetry && !expr.empty_clause()) {
+            sym(expr);
+            pif.message(2, format(
+                "symmetry breaking added {} clauses for {} generators",
+                sym.num_added_clauses(), sym.num_generators()
+            ));
         }
-        cnf::cnf_expr expr(istr);
         orchestrator orc(pif);
-        auto result = orc(expr);
+        auto result = orc(expr, pre);
         auto& sol = result.second;
+        sym.report(sol.stats());
         if (result.first == Status::Success) {
             ostr << sol;
             return sol.is_valid() ? 0 : 1;
@@ -29,14 +66,77 @@ namespace solve {
                 "s {} {} {} {}",
                 sol.get_type() == sol::ProblemType::CNF ? "cnf" : "sat",
                 "-1",
-                std::to_string(expr.get_max_var()),
+                std::to_string(expr.get_max_input_var()),
                 sol.get_type() == sol::ProblemType::CNF ?
-                    std::to_string(expr.get_num_clauses()) : ""
+                    std::to_string(expr.get_num_input_clauses()) : ""
             ) << std::endl;
             return 2;
         }
     }
 
+    // read a problem through the cache directory
+    // a problem found in the cache is loaded in binary form; any other is
+    // parsed and then added to the cache
+    inline void read_cached_problem(const program_interface& pif, cnf::cnf_expr& expr, std::string_view text) {
+        const std::string path = (
+            std::filesystem::path(pif.cache_dir) / cnf::io::cache_name(text, pif.encoding)
+        ).string();
+        if (std::filesystem::exists(path)) {
+            try {
+                cnf::io::read_cnf_problem(expr, path);
+                pif.message(2, "the problem was loaded from the cache at " + path);
+                return;
+            } catch (std::exception& e) {
+                pif.warn(format("the cached problem at {} could not be read: {}", path, e.what()));
+                expr = cnf::cnf_expr();
+            }
+        }
+        cnf::io::extract_cnf_problem(expr, text, pif.threads, pif.encoding);
+        if (cnf::io::write_binary_problem(expr, path)) {
+            pif.message(2, "the problem was added to the cache at " + path);
+        } else {
+            pif.warn("the problem could not be added to the cache at " + path);
+        }
+    }
+
+    // solve the problem read from a stream
+    int run_portfolio(const program_interface& pif, std::istream& istr, std::ostream& ostr) {
+        if (interrupted(pif)) {
+            return 2;
+        }
+        cnf::cnf_expr expr;
+        if (pif.cache_dir.empty()) {
+            cnf::io::extract_cnf_problem(expr, istr, pif.threads, pif.encoding);
+        } else {
+            const std::string text = cnf::io::read_stream(istr);
+            if (cnf::io::is_binary_problem(text)) {
+                cnf::io::load_binary_problem(expr, text);
+            } else {
+                read_cached_problem(pif, expr, text);
+            }
+        }
+        return solve_problem(pif, expr, ostr);
+    }
+
+    // solve the problem in a file
+    int run_portfolio(const program_interface& pif, const std::string& path, std::ostream& ostr) {
+        if (interrupted(pif)) {
+            return 2;
+        }
+        cnf::cnf_expr expr;
+        if (pif.cache_dir.empty()) {
+            cnf::io::read_cnf_problem(expr, path, pif.threads, pif.encoding);
+        } else {
+            cnf::io::file_view file(path);
+            if (cnf::io::is_binary_problem(file.contents())) {
+                cnf::io::load_binary_problem(expr, file.contents());
+            } else {
+                read_cached_problem(pif, expr, file.contents());
+            }
+        }
+        return solve_problem(pif, expr, ostr);
+    }
+
     // forward declaration
     namespace cli {
         void extract_program_options(program_interface&, int, char**);
@@ -53,7 +153,13 @@ namespace solve {
         print_help(false),
         print_formats(false),
         print_solvers(false),
-        solver(solver::SolverType::Auto)
+        solver(solver::SolverType::Auto),
+        encoding(cnf::Encoding::Tseitin),
+        preprocess(true),
+        preprocess_time(0),
+        symmetry(false),
+        heuristic(solver::Heuristic::VSIDS),
+        restarts{solver::Restarts::Glucose, solver::Restarts::Luby, solver::Restarts::Geometric}
     {
         cli::extract_program_options(*this, argc, argv);
         message(2, format("the verbosity is set to {}", verbosity));
@@ -66,6 +172,34 @@ namespace solve {
                                                         "undefined"s
         ));
         message(2, format("the portfolio is set to use {} threads", threads));
+        if (encoding == cnf::Encoding::Expansion) {
+            message(2, "SAT formulas are expanded without new variables");
+        }
+        if (!preprocess) {
+            message(2, "preprocessing is disabled");
+        } else {
+            message(2, format("preprocessing has a time limit of {} milliseconds", preprocess_time.count()));
+        }
+        if (symmetry) {
+            message(2, "symmetries are broken before solving");
+        }
+        message(2, "the branching heuristic is set to "s + (
+            heuristic == solver::Heuristic::VSIDS ? "vsids"s :
+            heuristic == solver::Heuristic::VMTF  ? "vmtf"s  :
+            heuristic == solver::Heuristic::Order ? "order"s :
+                                                    "undefined"s
+        ));
+        std::string policies;
+        for (const solver::Restarts& policy : restarts) {
+            policies += (policies.empty() ? ""s : ", "s) + (
+                policy == solver::Restarts::Glucose   ? "glucose"s   :
+                policy == solver::Restarts::Luby      ? "luby"s      :
+                policy == solver::Restarts::Geometric ? "geometric"s :
+                policy == solver::Restarts::Never     ? "never"s     :
+                                                        "undefined"s
+            );
+        }
+        message(2, "the cdcl restart policies are set to " + policies);
         if (incomplete) {
             message(2, format("the portfolio is allowed to never prove unsatisfiability", threads));
         }
@@ -166,7 +300,14 @@ namespace solve {
                 ("incomplete,i", info::s_flags::incomplete.c_str())
                 ("threads,t", opts::value<uint>(), info::s_flags::threads.c_str())
                 ("duration,d", opts::value<duration_t>(), info::s_flags::duration.c_str())
-                ("memory,m", opts::value<memory_t>(), info::s_flags::memory.c_str());
+                ("memory,m", opts::value<memory_t>(), info::s_flags::memory.c_str())
+                ("expand,e", info::s_flags::expand.c_str())
+                ("cache-dir,c", opts::value<std::string>(), info::s_flags::cache_dir.c_str())
+                ("no-preprocess,n", info::s_flags::no_preprocess.c_str())
+                ("preprocess-time,b", opts::value<duration_t>(), info::s_flags::preprocess_time.c_str())
+                ("symmetry,y", info::s_flags::symmetry.c_str())
+                ("branching,r", opts::value<std::string>(), info::s_flags::branching.c_str())
+                ("restarts,g", opts::value<std::string>(), info::s_flags::restarts.c_str());
 
             // a value without corresponding flag is assumed to be the problem file
             pif.pos.add("problem", -1);
@@ -224,8 +365,8 @@ namespace solve {
             }
             // set problem file
             if (pif.var_map.count("problem") == 1) {
-                pif.pstr = std::fstream(pif.var_map["problem"].as<std::string>());
-                if (!pif.pstr) {
+                pif.problem_path = pif.var_map["problem"].as<std::string>();
+                if (!std::ifstream(pif.problem_path)) {
                     throw std::invalid_argument(err::not_open_file);
                 }
             } else if (pif.var_map.count("problem") > 1) {
@@ -257,6 +398,75 @@ namespace solve {
             } else if (pif.var_map.count("memory") > 1) {
                 throw std::invalid_argument(err::repeat_options);
             }
+            // set encoding
+            if (pif.var_map.count("expand")) {
+                pif.encoding = cnf::Encoding::Expansion;
+            }
+            // set cache directory
+            if (pif.var_map.count("cache-dir") == 1) {
+                pif.cache_dir = pif.var_map["cache-dir"].as<std::string>();
+                std::error_code error;
+                std::filesystem::create_directories(pif.cache_dir, error);
+                if (!std::filesystem::is_directory(pif.cache_dir, error)) {
+                    throw std::invalid_argument(err::cache_dir);
+                }
+            } else if (pif.var_map.count("cache-dir") > 1) {
+                throw std::invalid_argument(err::repeat_options);
+            }
+            // set preprocessing
+            if (pif.var_map.count("no-preprocess")) {
+                pif.preprocess = false;
+            }
+            // set preprocessing time limit
+            if (pif.var_map.count("preprocess-time") == 1) {
+                pif.preprocess_time = pif.var_map["preprocess-time"].as<duration_t>().val;
+            } else if (pif.var_map.count("preprocess-time") > 1) {
+                throw std::invalid_argument(err::repeat_options);
+            } else {
+                pif.preprocess_time = std::chrono::duration_cast<std::chrono::milliseconds>(pif.duration) / 10;
+            }
+            // set symmetry breaking
+            if (pif.var_map.count("symmetry")) {
+                pif.symmetry = true;
+            }
+            // set branching heuristic
+            if (pif.var_map.count("branching") == 1) {
+                std::string heuristic = pif.var_map["branching"].as<std::string>();
+                if (heuristic == std::string("vsids")) {
+                    pif.heuristic = solver::Heuristic::VSIDS;
+                } else if (heuristic == std::string("vmtf")) {
+                    pif.heuristic = solver::Heuristic::VMTF;
+                } else if (heuristic == std::string("order")) {
+                    pif.heuristic = solver::Heuristic::Order;
+                } else {
+                    throw std::invalid_argument(err::invalid_heuristic);
+                }
+            } else if (pif.var_map.count("branching") > 1) {
+                throw std::invalid_argument(err::repeat_options);
+            }
+            // set restart policies
+            if (pif.var_map.count("restarts") == 1) {
+                std::stringstream list(pif.var_map["restarts"].as<std::string>());
+                pif.restarts.clear();
+                for (std::string policy; std::getline(list, policy, ',');) {
+                    if (policy == std::string("glucose")) {
+                        pif.restarts.push_back(solver::Restarts::Glucose);
+                    } else if (policy == std::string("luby")) {
+                        pif.restarts.push_back(solver::Restarts::Luby);
+                    } else if (policy == std::string("geometric")) {
+                        pif.restarts.push_back(solver::Restarts::Geometric);
+                    } else if (policy == std::string("never")) {
+                        pif.restarts.push_back(solver::Restarts::Never);
+                    } else {
+                        throw std::invalid_argument(err::invalid_restarts);
+                    }
+                }
+                if (pif.restarts.empty()) {
+                    throw std::invalid_argument(err::invalid_restarts);
+                }
+            } else if (pif.var_map.count("restarts") > 1) {
+                throw std::invalid_argument(err::repeat_options);
+            }
 
         }
 
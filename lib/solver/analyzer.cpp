@@ -0,0 +1,68 @@
+// analyzer.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "analyzer.hpp"
+#include <algorithm>
+
+namespace solver {
+
+    using std::abs;
+
+    // problem constructor
+    analyzer::analyzer(const cnf::cnf_expr& expr):
+        seen(static_cast<std::size_t>(expr.get_max_var()) + 1, false)
+    {}
+
+    // derive a learned clause from a conflict
+    int analyzer::operator()(const propagator& prop, clause conflict, std::vector<literal>& learned, brancher& decide, clause_db& db) {
+        const std::vector<literal>& trail = prop.get_trail();
+        // the first slot is kept for the literal of the current level
+        learned.assign(1, 0);
+        std::size_t index(trail.size());
+        // literals of the current level not yet resolved away
+        int pending(0);
+        // the trail literal last resolved on
+        literal resolved(0);
+        clause reason(conflict);
+        while (true) {
+            db.bump(prop, reason);
+            for (const literal& lit : prop.get_clause(reason)) {
+                const variable var = abs(lit);
+                if (lit == resolved || seen[var] || prop.level_of(var) == 0) {
+                    continue;
+                }
+                seen[var] = true;
+                decide.bump(var);
+                if (prop.level_of(var) == prop.level()) {
+                    pending++;
+                } else {
+                    learned.push_back(lit);
+                }
+            }
+            // the latest assignment in the clause is resolved on next
+            do {
+                index--;
+            } while (!seen[abs(trail[index])]);
+            resolved = trail[index];
+            seen[abs(resolved)] = false;
+            if (--pending == 0) {
+                break;
+            }
+            reason = prop.reason_of(abs(resolved));
+        }
+        learned[0] = -resolved;
+
+        // the backjump level is the greatest of the other literals
+        int backjump_level(0);
+        for (std::size_t i(1); i < learned.size(); i++) {
+            seen[abs(learned[i])] = false;
+            if (prop.level_of(abs(learned[i])) > backjump_level) {
+                backjump_level = prop.level_of(abs(learned[i]));
+                std::swap(learned[1], learned[i]);
+            }
+        }
+        return backjump_level;
+    }
+
+}
@@ -0,0 +1,191 @@
+// brancher.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "brancher.hpp"
+#include <algorithm>
+
+namespace solver {
+
+    using std::abs;
+
+    // the factor by which the EVSIDS increment grows after each conflict
+    static constexpr double vsids_growth = 1 / 0.95;
+    // the activity above which all activities are scaled down
+    static constexpr double vsids_limit = 1e100;
+
+    // problem constructor
+    brancher::brancher(const cnf::cnf_expr& expr, Heuristic heuristic):
+        heuristic(heuristic),
+        is_bumped(expr.get_max_var() + 1, false),
+        increment(1),
+        front(0),
+        search(0),
+        time(0)
+    {
+        // only variables in active clauses need to be decided
+        std::vector<bool> present(expr.get_max_var() + 1, false);
+        for (const clause& cl : expr.get_clauses()) {
+            for (const literal& lit : expr.get_clause(cl)) {
+                present[abs(lit)] = true;
+            }
+        }
+        if (heuristic == Heuristic::VSIDS) {
+            activity.assign(expr.get_max_var() + 1, 0);
+            position.assign(expr.get_max_var() + 1, none);
+            for (variable var(1); var <= expr.get_max_var(); var++) {
+                if (present[var]) heap_insert(var);
+            }
+        } else {
+            prev.assign(expr.get_max_var() + 1, 0);
+            next.assign(expr.get_max_var() + 1, 0);
+            stamp.assign(expr.get_max_var() + 1, 0);
+            // the lowest variable ends up at the front
+            for (variable var(expr.get_max_var()); var > 0; var--) {
+                if (!present[var]) continue;
+                prev[var] = front;
+                if (front != 0) next[front] = var;
+                front = var;
+                stamp[var] = ++time;
+            }
+            search = front;
+        }
+    }
+
+    // note that a variable took part in a conflict
+    void brancher::bump(variable var) {
+        if (!is_bumped[var]) {
+            is_bumped[var] = true;
+            bumped.push_back(var);
+        }
+    }
+
+    // apply the bumps noted since the last conflict
+    void brancher::conflict() {
+        if (heuristic == Heuristic::VSIDS) {
+            for (const variable& var : bumped) {
+                activity[var] += increment;
+                if (activity[var] > vsids_limit) {
+                    for (double& act : activity) {
+                        act /= vsids_limit;
+                    }
+                    increment /= vsids_limit;
+                }
+                if (position[var] != none) {
+                    sift_up(position[var]);
+                }
+            }
+            increment *= vsids_growth;
+        } else if (heuristic == Heuristic::VMTF) {
+            // keep the order in which the bumped variables were last moved
+            std::sort(bumped.begin(), bumped.end(), [&](variable a, variable b) {
+                return stamp[a] < stamp[b];
+            });
+            for (const variable& var : bumped) {
+                move_to_front(var);
+            }
+        }
+        for (const variable& var : bumped) {
+            is_bumped[var] = false;
+        }
+        bumped.clear();
+    }
+
+    // restore the variables the propagator will unassign
+    void brancher::backtrack(const propagator& prop, int target_level) {
+        const std::vector<literal>& trail = prop.get_trail();
+        for (std::size_t i(trail.size()); i > 0; i--) {
+            const variable var = abs(trail[i - 1]);
+            if (prop.level_of(var) <= target_level) break;
+            if (heuristic == Heuristic::VSIDS) {
+                if (position[var] == none) heap_insert(var);
+            } else if (stamp[var] > stamp[search]) {
+                search = var;
+            }
+        }
+    }
+
+    // return an unassigned variable, or 0 if all are assigned
+    variable brancher::pick(const propagator& prop) {
+        if (heuristic == Heuristic::VSIDS) {
+            while (!heap.empty()) {
+                const variable var = heap_pop();
+                if (prop.value(var) == 0) return var;
+            }
+            return 0;
+        }
+        while (search != 0 && prop.value(search) != 0) {
+            search = prev[search];
+        }
+        return search;
+    }
+
+    // add a variable to the heap
+    void brancher::heap_insert(variable var) {
+        position[var] = heap.size();
+        heap.push_back(var);
+        sift_up(position[var]);
+    }
+
+    // remove the top of the heap
+    variable brancher::heap_pop() {
+        const variable top = heap.front();
+        position[top] = none;
+        const variable last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            position[last] = 0;
+            sift_down(0);
+        }
+        return top;
+    }
+
+    // move a heap entry towards the top until it is in order
+    void brancher::sift_up(std::uint32_t i) {
+        const variable var = heap[i];
+        while (i > 0) {
+            const std::uint32_t parent = (i - 1) / 2;
+            if (activity[heap[parent]] >= activity[var]) break;
+            heap[i] = heap[parent];
+            position[heap[i]] = i;
+            i = parent;
+        }
+        heap[i] = var;
+        position[var] = i;
+    }
+
+    // move a heap entry towards the bottom until it is in order
+    void brancher::sift_down(std::uint32_t i) {
+        const variable var = heap[i];
+        while (2 * static_cast<std::size_t>(i) + 1 < heap.size()) {
+            std::uint32_t child = 2 * i + 1;
+            if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]]) {
+                child++;
+            }
+            if (activity[heap[child]] <= activity[var]) break;
+            heap[i] = heap[child];
+            position[heap[i]] = i;
+            i = child;
+        }
+        heap[i] = var;
+        position[var] = i;
+    }
+
+    // move a variable to the front of the queue
+    void brancher::move_to_front(variable var) {
+        stamp[var] = ++time;
+        if (var == front) return;
+        // every variable in front of the search position stays assigned
+        if (var == search) {
+            search = next[var];
+        }
+        if (prev[var] != 0) next[prev[var]] = next[var];
+        prev[next[var]] = prev[var];
+        prev[var] = front;
+        next[var] = 0;
+        next[front] = var;
+        front = var;
+    }
+
+}
@@ -4,18 +4,45 @@
 
 #include "solver.hpp"
 #include "solve.hpp"
+#include <bit>
 
 namespace solver {
 
+    using std::abs;
+
     // problem constructor
     brute_force::brute_force(const cnf::cnf_expr& prob, solve::orchestrator& orchestrator):
         basic_solver(prob, orchestrator)
     {}
 
+    // number of variables whose values are fixed by lane
+    constexpr std::size_t lane_vars = 6;
+
+    // the lanes in which each lane variable is true
+    // lane i gives the k-th lane variable the k-th bit of i
+    constexpr std::uint64_t lane_masks[lane_vars] = {
+        0xAAAAAAAAAAAAAAAA, 0xCCCCCCCCCCCCCCCC, 0xF0F0F0F0F0F0F0F0,
+        0xFF00FF00FF00FF00, 0xFFFF0000FFFF0000, 0xFFFFFFFF00000000
+    };
+
+    // the lanes in which a clause is satisfied
+    inline std::uint64_t clause_mask(cnf::lit_span lits, const std::vector<std::uint64_t>& masks) {
+        std::uint64_t mask(0);
+        for (const literal& lit : lits) {
+            mask |= lit > 0 ? masks[lit] : ~masks[-lit];
+        }
+        return mask;
+    }
+
     // run the algorithm
+    // Sixty-four assignments are checked at once, one per bit of a word. The
+    // first variables take their values from the lane index, and the rest
+    // are enumerated in Gray code order, so each step flips one variable and
+    // revisits only the clauses containing it.
     void brute_force::operator()(std::stop_token token) try {
         orc.pif.message(2, "brute_force solver starting");
         auto start_time = time.now();
+        std::uint64_t checked(0);
         // check for empty expression
         if (expr.get_num_clauses() == 0) {
             sol.set_valid(true);
@@ -23,30 +50,107 @@ namespace solver {
             // check for empty clauses
             sol.set_valid(false);
         } else {
-            for (const auto& var : expr.variables()) {
-                sol.assign_variable(var, false);
+            // gather the variables of the active clauses and where they occur
+            const cnf::cl_list& clauses = expr.get_clauses();
+            std::vector<variable> free_vars;
+            std::vector<std::vector<std::uint32_t>> occurs(expr.get_max_var() + 1);
+            for (std::uint32_t i(0); i < clauses.size(); i++) {
+                for (const literal& lit : expr.get_clause(clauses[i])) {
+                    if (occurs[abs(lit)].empty()) {
+                        free_vars.push_back(abs(lit));
+                    }
+                    occurs[abs(lit)].push_back(i);
+                }
+            }
+            std::sort(free_vars.begin(), free_vars.end());
+
+            // the first assignment: lane variables by lane, the rest false
+            std::vector<std::uint64_t> masks(expr.get_max_var() + 1, 0);
+            for (std::size_t i(0); i < std::min(lane_vars, free_vars.size()); i++) {
+                masks[free_vars[i]] = lane_masks[i];
             }
-            while (!expr.eval(sol.map())) {
-                auto iter(sol.map().begin());
-                while (iter != sol.map().end() && iter->second) {
-                    sol.reassign_variable((iter++)->first, false);
+            // track the clauses no lane satisfies, and those only some lanes do
+            constexpr std::uint64_t all_lanes = ~std::uint64_t(0);
+            constexpr std::uint32_t not_partial = std::numeric_limits<std::uint32_t>::max();
+            std::vector<std::uint64_t> cl_masks(clauses.size());
+            std::vector<std::uint32_t> partial;
+            std::vector<std::uint32_t> partial_pos(clauses.size(), not_partial);
+            std::size_t num_dead(0);
+            auto track = [&](std::uint32_t i) {
+                if (cl_masks[i] == 0) {
+                    num_dead++;
+                } else if (cl_masks[i] != all_lanes) {
+                    partial_pos[i] = partial.size();
+                    partial.push_back(i);
+                }
+            };
+            auto untrack = [&](std::uint32_t i) {
+                if (cl_masks[i] == 0) {
+                    num_dead--;
+                } else if (cl_masks[i] != all_lanes) {
+                    partial[partial_pos[i]] = partial.back();
+                    partial_pos[partial.back()] = partial_pos[i];
+                    partial.pop_back();
+                    partial_pos[i] = not_partial;
+                }
+            };
+            // the lanes satisfying every clause
+            auto solved_lanes = [&]() -> std::uint64_t {
+                if (num_dead > 0) return 0;
+                std::uint64_t lanes(all_lanes);
+                for (const std::uint32_t& i : partial) {
+                    lanes &= cl_masks[i];
                 }
-                if (iter != sol.map().end()) {
-                    sol.reassign_variable(iter->first, true);
-                } else break;
+                return lanes;
+            };
+            for (std::uint32_t i(0); i < clauses.size(); i++) {
+                cl_masks[i] = clause_mask(expr.get_clause(clauses[i]), masks);
+                track(i);
+            }
+            std::uint64_t solved = solved_lanes();
+
+            // walk the remaining variables in Gray code order
+            const std::size_t gray_vars = free_vars.size() - std::min(lane_vars, free_vars.size());
+            const std::uint64_t last_step = gray_vars >= 64 ?
+                std::numeric_limits<std::uint64_t>::max() :
+                (std::uint64_t(1) << gray_vars) - 1;
+            std::uint64_t step(0);
+            while (solved == 0 && step < last_step) {
+                step++;
+                // flip the variable of the step's lowest set bit
+                const variable var = free_vars[lane_vars + std::countr_zero(step)];
+                masks[var] = ~masks[var];
+                for (const std::uint32_t& i : occurs[var]) {
+                    const std::uint64_t mask = clause_mask(expr.get_clause(clauses[i]), masks);
+                    if (mask == cl_masks[i]) continue;
+                    untrack(i);
+                    cl_masks[i] = mask;
+                    track(i);
+                }
+                solved = solved_lanes();
                 // check for a stop signal
-                if (time.now() - last_stop_check > std::chrono::milliseconds(100)) {
+                if ((step & 0xFFF) == 0 && time.now() - last_stop_check > std::chrono::milliseconds(100)) {
                     last_stop_check = time.now();
                     if (token.stop_requested()) {
                         return;
                     }
                 }
             }
-            sol.set_valid(expr.eval(sol.map()));
+            checked = (step + 1) * 64;
+
+            // read the assignment from a solved lane
+            if (solved != 0) {
+                const int lane = std::countr_zero(solved);
+                for (const variable& var : free_vars) {
+                    sol.assign_variable(var, (masks[var] >> lane) & 1);
+                }
+            }
+            sol.set_valid(solved != 0);
         }
         // report the solution
         std::chrono::duration<double> elapsed_time = time.now() - start_time;
         sol.stats().insert({"ELAPSED_TIME_SECONDS", std::to_string(elapsed_time.count())});
+        sol.stats().insert({"ASSIGNMENTS_CHECKED", std::to_string(checked)});
         if (sol.is_valid()) {
             orc.report_solution(std::move(sol), SolverType::BruteForce);
         } else {
@@ -57,6 +161,7 @@ namespace solver {
         return;
     }
 
+    // divide the enumeration space by fixing a prefix of the variables
     std::vector<brute_force> brute_force::divide(uint num_sub_problems) {
         std::vector<brute_force> reduced_solvers;
         // variables in expression
@@ -0,0 +1,154 @@
+// clause_db.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "clause_db.hpp"
+#include <algorithm>
+
+namespace solver {
+
+    using std::abs;
+
+    // the greatest LBD of the core and of the second tier
+    static constexpr int core_lbd = 2;
+    static constexpr int tier2_lbd = 6;
+    // conflicts before the first reduction, and the growth of the interval
+    static constexpr std::uint64_t first_reduction = 2000;
+    static constexpr std::uint64_t reduction_growth = 300;
+    // the factor by which the activity increment grows after each conflict
+    static constexpr double activity_growth = 1 / 0.999;
+    // the activity above which all activities are scaled down
+    static constexpr double activity_limit = 1e20;
+
+    // problem constructor
+    clause_db::clause_db(const cnf::cnf_expr& expr):
+        level_stamps(expr.get_max_var() + 1, 0),
+        stamp(0),
+        increment(1),
+        conflicts(0),
+        next_reduction(first_reduction),
+        reduction_interval(first_reduction),
+        num_learned(0),
+        num_deleted(0),
+        num_reductions(0),
+        total_lbd(0)
+    {}
+
+    // give the tier of a clause with the given LBD
+    clause_db::Tier clause_db::tier_of(int lbd) {
+        return lbd <= core_lbd ? Tier::Core : lbd <= tier2_lbd ? Tier::Tier2 : Tier::Local;
+    }
+
+    // give the LBD of a clause whose literals are all assigned
+    int clause_db::lbd(const propagator& prop, cnf::lit_span lits) {
+        stamp++;
+        int count(0);
+        for (const literal& lit : lits) {
+            const int level = prop.level_of(abs(lit));
+            if (level_stamps[level] != stamp) {
+                level_stamps[level] = stamp;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // add a learned clause with its LBD to the propagator
+    clause clause_db::add(propagator& prop, cnf::lit_span lits, int lbd) {
+        conflicts++;
+        num_learned++;
+        total_lbd += lbd;
+        increment *= activity_growth;
+        // unit clauses are fixed at level zero and need no record
+        if (lits.size() < 2) {
+            return prop.add_clause(lits);
+        }
+        const clause cl = prop.add_clause(lits, learned.size());
+        learned.push_back({cl, lbd, increment, tier_of(lbd), false});
+        return cl;
+    }
+
+    // note that a clause took part in a conflict
+    void clause_db::bump(const propagator& prop, clause cl) {
+        const int id = prop.id_of(cl);
+        if (id == propagator::no_id) return;
+        entry& e = learned[id];
+        e.used = true;
+        e.activity += increment;
+        if (e.activity > activity_limit) {
+            for (entry& other : learned) {
+                other.activity /= activity_limit;
+            }
+            increment /= activity_limit;
+        }
+        if (e.tier != Tier::Core) {
+            const int new_lbd = lbd(prop, prop.get_clause(cl));
+            if (new_lbd < e.lbd) {
+                e.lbd = new_lbd;
+                e.tier = std::min(e.tier, tier_of(new_lbd));
+            }
+        }
+    }
+
+    // check whether the store is due to be reduced
+    bool clause_db::due() const {
+        return conflicts >= next_reduction;
+    }
+
+    // remove the least useful local clauses
+    void clause_db::reduce(propagator& prop) {
+        num_reductions++;
+        reduction_interval += reduction_growth;
+        next_reduction = conflicts + reduction_interval;
+
+        // the unused local clauses that may be removed, least active first
+        std::vector<std::uint32_t> candidates;
+        for (std::uint32_t i(0); i < learned.size(); i++) {
+            entry& e = learned[i];
+            if (e.tier == Tier::Local && !e.used && !prop.is_reason(e.cl)) {
+                candidates.push_back(i);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return learned[a].activity < learned[b].activity;
+        });
+        std::vector<bool> removed(learned.size(), false);
+        for (std::size_t i(0); i < candidates.size() / 2; i++) {
+            removed[candidates[i]] = true;
+            prop.remove_clause(learned[candidates[i]].cl);
+        }
+        num_deleted += candidates.size() / 2;
+
+        // keep the rest, and demote second tier clauses left unused
+        std::vector<entry> kept;
+        std::vector<clause> handles;
+        kept.reserve(learned.size() - candidates.size() / 2);
+        for (std::uint32_t i(0); i < learned.size(); i++) {
+            if (removed[i]) continue;
+            entry& e = learned[i];
+            if (e.tier == Tier::Tier2 && !e.used) {
+                e.tier = Tier::Local;
+            }
+            e.used = false;
+            kept.push_back(e);
+            handles.push_back(e.cl);
+        }
+        prop.collect(handles);
+        for (std::uint32_t i(0); i < kept.size(); i++) {
+            kept[i].cl = handles[i];
+            prop.set_id(handles[i], i);
+        }
+        learned.swap(kept);
+    }
+
+    // add the work done to a set of statistics
+    void clause_db::report(std::map<std::string, std::string>& stats) const {
+        stats.insert({"LEARNED_CLAUSES", std::to_string(num_learned)});
+        stats.insert({"DELETED_CLAUSES", std::to_string(num_deleted)});
+        stats.insert({"CLAUSE_DB_REDUCTIONS", std::to_string(num_reductions)});
+        stats.insert({"AVERAGE_LBD", std::to_string(
+            num_learned == 0 ? 0.0 : static_cast<double>(total_lbd) / num_learned
+        )});
+    }
+
+}
@@ -8,22 +8,21 @@
 namespace solver {
 
     using std::abs;
-    inline sol::solution sub_dpll(problem, std::stop_token&);
 
     // problem constructor
     dpll::dpll(const cnf::cnf_expr& prob, solve::orchestrator& orchestrator):
-        basic_solver(prob, orchestrator)
+        basic_solver(prob, orchestrator),
+        decisions(0),
+        clauses(std::make_shared<const cnf::cnf_expr>(prob))
     {}
 
     inline void simplify(cnf::cnf_expr& expr, sol::solution& sol) {
         // perform unit propagation
-        for (auto ucl(expr.unit_clause()); ucl != expr.clauses_end(); ucl = expr.unit_clause()) {
-            literal unit_lit = *((ucl->second).begin());
-            bool unit_val = unit_lit > 0 ? true : false;
-            sol.assign_variable(abs(unit_lit), unit_val);
-            expr.assign_and_simplify(abs(unit_lit), unit_val);
+        for (clause ucl(expr.unit_clause()); ucl != cnf::no_clause; ucl = expr.unit_clause()) {
+            literal ulit = expr.get_clause(ucl)[0];
+            sol.assign_variable(abs(ulit), ulit > 0);
+            expr.assign_and_simplify(abs(ulit), ulit > 0);
         }
-
         // perform pure literal deletion
         for (literal plit(expr.pure_literal()); plit != 0; plit = expr.pure_literal()) {
             bool pure_val = plit > 0 ? true : false;
@@ -41,24 +40,33 @@ namespace solver {
         simplify(expr, sol);
 
         // find the solution to the reduced problem
-        auto final_sol = sub_dpll({expr, sol}, token);
+        propagator prop(expr);
+        brancher decide(expr, orc.pif.heuristic);
+        phaser phase(*clauses);
+        bool sat = search(prop, decide, phase, token);
         if (token.stop_requested()) {
-            final_sol.set_valid(false);
             return;
         }
 
-        // assign arbitrary values to the remaining variables
-        for (auto const& var : expr.variables()) {
-            if (!final_sol.map().contains(var)) {
-                final_sol.assign_variable(var, true);
-            }
-        }
-
         // report the solution
-        if (final_sol.is_valid()) {
+        if (sat) {
+            for (const literal& lit : prop.get_trail()) {
+                sol.assign_variable(abs(lit), lit > 0);
+            }
+            // assign arbitrary values to the remaining variables
+            for (auto const& var : expr.variables()) {
+                if (!sol.assignment().is_assigned(var)) {
+                    sol.assign_variable(var, true);
+                }
+            }
+            sol.set_valid(true);
             std::chrono::duration<double> elapsed_time = time.now() - start_time;
-            final_sol.stats().insert({"ELAPSED_TIME_SECONDS", std::to_string(elapsed_time.count())});
-            orc.report_solution(std::move(final_sol), SolverType::DPLL);
+            sol.stats().insert({"ELAPSED_TIME_SECONDS", std::to_string(elapsed_time.count())});
+            sol.stats().insert({"PROPAGATIONS", std::to_string(prop.num_propagations())});
+            sol.stats().insert({"WATCH_VISITS", std::to_string(prop.num_watch_visits())});
+            sol.stats().insert({"DECISIONS", std::to_string(decisions)});
+            phase.report(sol.stats());
+            orc.report_solution(std::move(sol), SolverType::DPLL);
         } else {
             orc.report_no_solution();
         }
@@ -67,59 +75,95 @@ namespace solver {
         return;
     }
 
-    inline problem reduce_problem(problem prob, variable var, bool val) {
-        auto& sub_expr = prob.first;
-        auto& curr_sol = prob.second;
-
-        // assign the value to the provided variable
-        curr_sol.assign_variable(var, val);
-        sub_expr.assign_and_simplify(var, val);
-
-        // apply heuristics
-        simplify(sub_expr, curr_sol);
-
-        // return the sub-problem
-        return prob;
-    }
-
-    // find the solution for a reduced problem
-    sol::solution dpll::sub_dpll(problem prob, std::stop_token& token) {
-        auto& sub_expr = prob.first;
-        auto& curr_sol = prob.second;
-
-        // check for a stop signal
-        if (time.now() - last_stop_check > std::chrono::milliseconds(100)) {
-            last_stop_check = time.now();
-            if (token.stop_requested()) {
-                curr_sol.set_valid(true);
-                return curr_sol;
+    // a decision level of the search
+    struct decision_frame {
+        // the literal assigned by the decision
+        literal decision;
+        // whether the opposite branch has been taken
+        bool flipped;
+        // the expression's undo mark before the decision
+        std::size_t expr_mark;
+    };
+
+    // search for a solution, keeping the expression in step with the trail
+    // The variables of each conflicting clause are bumped in the brancher,
+    // so later decisions favour the variables that lead to conflicts, and
+    // the first branch of each decision follows the saved phases.
+    bool dpll::search(propagator& prop, brancher& decide, phaser& phase, std::stop_token& token) {
+        std::vector<decision_frame> stack;
+        std::size_t synced(0);
+        clause conflict = prop.propagate();
+        while (true) {
+            // check for a stop signal
+            if (time.now() - last_stop_check > std::chrono::milliseconds(100)) {
+                last_stop_check = time.now();
+                if (token.stop_requested()) {
+                    return true;
+                }
             }
-        }
 
-        // check for empty expression
-        if (sub_expr.get_num_clauses() == 0) {
-            curr_sol.set_valid(true);
-            return curr_sol;
-        }
+            if (conflict == cnf::no_clause) {
+                // simplify the expression by the new assignments
+                const std::vector<literal>& trail = prop.get_trail();
+                for (; synced < trail.size(); synced++) {
+                    expr.assign_and_simplify(abs(trail[synced]), trail[synced] > 0);
+                }
+                // perform pure literal deletion
+                literal plit = expr.pure_literal();
+                if (plit != 0) {
+                    prop.enqueue(plit);
+                    conflict = prop.propagate();
+                    continue;
+                }
+                // check for empty expression
+                if (expr.get_num_clauses() == 0) {
+                    return true;
+                }
+                // a variable left in no active clause needs no decision
+                variable branch_var = decide.pick(prop);
+                if (!expr.is_active(branch_var)) {
+                    prop.enqueue(branch_var);
+                    continue;
+                }
+                // reset the saved phases
+                if (phase.due()) {
+                    phase.rephase(token);
+                }
+                // branch left
+                decisions++;
+                const literal branch_lit = phase.decide(branch_var);
+                stack.push_back({branch_lit, false, expr.checkpoint()});
+                prop.new_level();
+                prop.enqueue(branch_lit);
+                conflict = prop.propagate();
+                continue;
+            }
 
-        // check for empty clauses
-        if (sub_expr.empty_clause()) {
-            // return an invalid solution
-            return curr_sol;
+            for (const literal& lit : prop.get_clause(conflict)) {
+                decide.bump(abs(lit));
+            }
+            decide.conflict();
+            phase.conflict();
+            // return to the latest decision with an untried branch
+            while (!stack.empty() && stack.back().flipped) {
+                stack.pop_back();
+            }
+            if (stack.empty()) {
+                return false;
+            }
+            decision_frame& top = stack.back();
+            decide.backtrack(prop, stack.size() - 1);
+            phase.backtrack(prop, stack.size() - 1);
+            prop.backtrack(stack.size() - 1);
+            expr.undo(top.expr_mark);
+            synced = prop.get_trail().size();
+            // branch right
+            top.flipped = true;
+            top.decision = -top.decision;
+            prop.new_level();
+            prop.enqueue(top.decision);
+            conflict = prop.propagate();
         }
-
-        // pick a branch variable
-        variable branch_var = sub_expr.pick_var();
-
-        // branch left
-        auto sol_left = sub_dpll(reduce_problem(prob, branch_var, false), token);
-        if (sol_left.is_valid()) return sol_left;
-
-        // branch right
-        auto sol_right = sub_dpll(reduce_problem(prob, branch_var, true), token);
-        if (sol_right.is_valid()) return sol_right;
-
-        return curr_sol;
     }
 
     std::vector<dpll> dpll::divide(uint num_sub_problems) {
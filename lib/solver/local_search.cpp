@@ -8,6 +8,7 @@
 namespace solver {
 
     using std::abs;
+    using cnf::lit_index;
 
     // problem constructor
     local_search::local_search(const cnf::cnf_expr& prob, solve::orchestrator& orchestrator):
@@ -15,70 +16,108 @@ namespace solver {
         rand(std::random_device()())
     {}
 
-    inline literal select_optimal_literal(
+    // make up to the given number of WalkSAT flips from an assignment,
+    // or until a stop is requested
+    // Each clause keeps a count of its true literals, and the unsatisfied
+    // clauses are kept in a list with the position of each, so a flip only
+    // visits the clauses of the flipped variable.
+    bool local_search::walk(
         const cnf::cnf_expr& expr,
-        const sol::solution& sol,
-        clause target_cl
+        cnf::assignment& values,
+        std::uint64_t max_flips,
+        std::mt19937_64& rand,
+        std::stop_token token
     ) {
-        unsigned long int min_new_unsat = ULONG_MAX;
-        literal target_lit;
-        for (auto const& lit : expr.get_clause(target_cl)) {
-            // examine each literal
-            unsigned long int will_unsatisfy_clauses = 0;
-            if (sol.map().at(abs(lit))) {
-                // variable is currently assigned true
-                for (auto const& cl : expr.get_literal(abs(lit))) {
-                    // examine each clause in which the positive literal appears
-                    bool satisfied(false);
-                    for (auto const& other_lit : expr.get_clause(cl)) {
-                        // check for another literal satisfying the clause
-                        if (other_lit == lit) continue;
-                        if (
-                            other_lit > 0 ?
-                            sol.map().at(abs(other_lit)) :
-                            !sol.map().at(abs(other_lit))
-                        ) {
-                            satisfied = true;
-                            break;
-                        }
+        const double RAND_LIT_PROB = 0.2;
+        // flips between checks for a stop signal
+        const std::uint64_t FLIPS_PER_CHECK = 4096;
+        constexpr std::uint32_t none = UINT32_MAX;
+
+        // the clauses, and the clauses of each literal by their index
+        std::vector<cnf::lit_span> clauses;
+        std::vector<std::vector<std::uint32_t>> occurs(2 * (static_cast<std::size_t>(expr.get_max_var()) + 1));
+        for (const clause& cl : expr.get_clauses()) {
+            for (const literal& lit : expr.get_clause(cl)) {
+                occurs[lit_index(lit)].push_back(clauses.size());
+            }
+            clauses.push_back(expr.get_clause(cl));
+        }
+        // the true literals of each clause, and the unsatisfied clauses
+        std::vector<std::uint32_t> num_true(clauses.size(), 0);
+        std::vector<std::uint32_t> unsat;
+        std::vector<std::uint32_t> unsat_pos(clauses.size(), none);
+        for (std::uint32_t i(0); i < clauses.size(); i++) {
+            for (const literal& lit : clauses[i]) {
+                if (values.is_true(lit)) num_true[i]++;
+            }
+            if (num_true[i] == 0) {
+                unsat_pos[i] = unsat.size();
+                unsat.push_back(i);
+            }
+        }
+
+        cnf::assignment best(values);
+        std::size_t best_unsat(unsat.size());
+        std::uniform_real_distribution<double> real_dist(0, 1);
+        for (std::uint64_t flips(0); flips < max_flips && !unsat.empty(); flips++) {
+            // check for a stop signal
+            if (flips % FLIPS_PER_CHECK == 0 && token.stop_requested()) break;
+            // pick an unsatisfied clause
+            const cnf::lit_span target_cl = clauses[
+                unsat[std::uniform_int_distribution<std::size_t>(0, unsat.size() - 1)(rand)]
+            ];
+            if (target_cl.empty()) break;
+            // pick a literal
+            literal target_lit = target_cl[0];
+            if (real_dist(rand) > RAND_LIT_PROB) {
+                // select the literal that leaves the fewest clauses unsatisfied
+                std::size_t min_new_unsat = SIZE_MAX;
+                for (const literal& lit : target_cl) {
+                    std::size_t will_unsatisfy_clauses(0);
+                    for (const std::uint32_t& i : occurs[lit_index(-lit)]) {
+                        if (num_true[i] == 1) will_unsatisfy_clauses++;
+                    }
+                    if (will_unsatisfy_clauses < min_new_unsat) {
+                        min_new_unsat = will_unsatisfy_clauses;
+                        target_lit = lit;
                     }
-                    if (!satisfied) will_unsatisfy_clauses++;
                 }
             } else {
-                // variable is currently assigned false
-                for (auto const& cl : expr.get_literal(-abs(lit))) {
-                    // examine each clause in which the negative literal appears
-                    bool satisfied(false);
-                    for (auto const& other_lit : expr.get_clause(cl)) {
-                        // check for another literal satisfying the clause
-                        if (other_lit == lit) continue;
-                        if (
-                            other_lit > 0 ?
-                            sol.map().at(abs(other_lit)) :
-                            !sol.map().at(abs(other_lit))
-                        ) {
-                            satisfied = true;
-                            break;
-                        }
-                    }
-                    if (!satisfied) will_unsatisfy_clauses++;
+                // randomly select a literal
+                target_lit = target_cl[
+                    std::uniform_int_distribution<std::size_t>(0, target_cl.size() - 1)(rand)
+                ];
+            }
+            // flip the selected variable, making the literal true
+            const bool was_assigned = values.is_true(-target_lit);
+            values.assign(target_lit);
+            for (const std::uint32_t& i : occurs[lit_index(target_lit)]) {
+                if (num_true[i]++ == 0) {
+                    unsat_pos[unsat.back()] = unsat_pos[i];
+                    unsat[unsat_pos[i]] = unsat.back();
+                    unsat.pop_back();
+                    unsat_pos[i] = none;
+                }
+            }
+            for (const std::uint32_t& i : occurs[lit_index(-target_lit)]) {
+                if (was_assigned && --num_true[i] == 0) {
+                    unsat_pos[i] = unsat.size();
+                    unsat.push_back(i);
                 }
             }
-            // check if this literal is better than previous
-            if (will_unsatisfy_clauses < min_new_unsat) {
-                min_new_unsat = will_unsatisfy_clauses;
-                target_lit = lit;
+            if (unsat.size() < best_unsat) {
+                best_unsat = unsat.size();
+                best = values;
             }
         }
-        return target_lit;
+        values = std::move(best);
+        return best_unsat == 0;
     }
 
     // a stochastic local search algorithm implementing WalkSAT
     void local_search::operator()(std::stop_token token) try {
         orc.pif.message(2, "local_search solver starting");
         auto start_time = time.now();
-        const double RAND_LIT_PROB = 0.2;
-        const std::size_t MAX_RAND_ADVANCE = 20;
 
         // a functor to provide a random bool value
         std::uniform_int_distribution<ushort> bit_dist(0, 1);
@@ -86,52 +125,18 @@ namespace solver {
             return bit_dist(rand) == 1 ? true : false;
         };
         // assign random values to variables
+        cnf::assignment values(expr.get_max_var());
         for (auto const& var : expr.variables()) {
-            sol.assign_variable(var, rand_bool());
+            values.assign(rand_bool() ? var : -var);
         }
-        // while the solution is invalid
-        while (!expr.eval(sol.map())) {
-            // pick a clause
-            auto unsat_clauses = expr.unsatisfied_clauses(sol.map());
-            auto cl_iter = unsat_clauses.begin();
-            std::advance(
-                cl_iter,
-                std::uniform_int_distribution<std::size_t>(
-                    0,
-                    std::min(MAX_RAND_ADVANCE, unsat_clauses.size()-1)
-                )(rand)
-            );
-            clause target_cl = *cl_iter;
-            // pick a variable
-            std::uniform_real_distribution<double> real_dist(0, 1);
-            if (real_dist(rand) > RAND_LIT_PROB) {
-                // select a literal carefully
-                literal target_lit = select_optimal_literal(expr, sol, target_cl);
-                // flip the selected variable
-                sol.reassign_variable(abs(target_lit), !sol.map().at(abs(target_lit)));
-            } else {
-                // randomly select a literal
-                auto lit_iter = expr.get_clause(target_cl).begin();
-                std::advance(
-                    lit_iter,
-                    std::uniform_int_distribution<std::size_t>(
-                        0,
-                        std::min(MAX_RAND_ADVANCE, expr.get_clause(target_cl).size()-1)
-                    )(rand)
-                );
-                literal target_lit = *lit_iter;
-                // flip the selected variable
-                sol.reassign_variable(abs(target_lit), !sol.map().at(abs(target_lit)));
-            }
-            // check for a stop signal
-            if (time.now() - last_stop_check > std::chrono::milliseconds(100)) {
-                last_stop_check = time.now();
-                if (token.stop_requested()) {
-                    return;
-                }
-            }
+        // walk until every clause is satisfied or a stop is requested
+        if (!walk(expr, values, UINT64_MAX, rand, token)) {
+            return;
         }
         // report the solution
+        for (auto const& var : expr.variables()) {
+            sol.assign_variable(var, values.is_true(var));
+        }
         std::chrono::duration<double> elapsed_time = time.now() - start_time;
         sol.stats().insert({"ELAPSED_TIME_SECONDS", std::to_string(elapsed_time.count())});
         sol.set_valid(true);
@@ -0,0 +1,136 @@
+// phaser.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "phaser.hpp"
+#include "solver.hpp"
+#include <algorithm>
+
+namespace solver {
+
+    using std::abs;
+
+    // conflicts between rephases; the n-th rephase follows n intervals later
+    static constexpr std::uint64_t rephase_interval = 1000;
+    // the flips a walk may make per clause, and in total
+    static constexpr std::uint64_t walk_flips_per_clause = 4;
+    static constexpr std::uint64_t max_walk_flips = 1'000'000;
+
+    // problem constructor
+    phaser::phaser(const cnf::cnf_expr& expr):
+        expr(expr),
+        saved(expr.get_max_var() + 1, -1),
+        target(expr.get_max_var() + 1, 0),
+        best(expr.get_max_var() + 1, 0),
+        target_size(0),
+        best_size(0),
+        conflicts(0),
+        next_rephase(rephase_interval),
+        rand(std::random_device()()),
+        num_rephases(0),
+        num_walks(0)
+    {}
+
+    // give the literal a decision on a variable should assign
+    literal phaser::decide(variable var) const {
+        const signed char phase = target[var] != 0 ? target[var] : saved[var];
+        return phase > 0 ? var : -var;
+    }
+
+    // save the phases of the variables the propagator will unassign
+    void phaser::backtrack(const propagator& prop, int target_level) {
+        const std::vector<literal>& trail = prop.get_trail();
+        // the assignments below the current level hold no conflict
+        std::size_t consistent(trail.size());
+        while (consistent > 0 && prop.level_of(abs(trail[consistent - 1])) == prop.level()) {
+            consistent--;
+        }
+        if (consistent > target_size) {
+            target_size = consistent;
+            for (std::size_t i(0); i < consistent; i++) {
+                target[abs(trail[i])] = trail[i] > 0 ? 1 : -1;
+            }
+        }
+        if (consistent > best_size) {
+            best_size = consistent;
+            for (std::size_t i(0); i < consistent; i++) {
+                best[abs(trail[i])] = trail[i] > 0 ? 1 : -1;
+            }
+        }
+        for (std::size_t i(trail.size()); i > 0; i--) {
+            const literal lit = trail[i - 1];
+            if (prop.level_of(abs(lit)) <= target_level) break;
+            saved[abs(lit)] = lit > 0 ? 1 : -1;
+        }
+    }
+
+    // note a conflict
+    void phaser::conflict() {
+        conflicts++;
+    }
+
+    // check whether a rephase is due
+    bool phaser::due() const {
+        return conflicts >= next_rephase;
+    }
+
+    // reset the saved phases
+    void phaser::rephase(std::stop_token token) {
+        // the order in which the saved phases are reset, repeated
+        static constexpr Phase rephase_schedule[] = {
+            Phase::Original, Phase::Best,
+            Phase::Inverted, Phase::Best,
+            Phase::Random, Phase::Best,
+            Phase::Walk, Phase::Best
+        };
+        const Phase phase = rephase_schedule[num_rephases % std::size(rephase_schedule)];
+        num_rephases++;
+        next_rephase = conflicts + rephase_interval * (num_rephases + 1);
+        switch (phase) {
+        case Phase::Original:
+            std::fill(saved.begin(), saved.end(), -1);
+            break;
+        case Phase::Inverted:
+            std::fill(saved.begin(), saved.end(), 1);
+            break;
+        case Phase::Random:
+            for (signed char& value : saved) {
+                value = std::uniform_int_distribution<int>(0, 1)(rand) ? 1 : -1;
+            }
+            break;
+        case Phase::Best:
+            for (std::size_t var(0); var < saved.size(); var++) {
+                if (best[var] != 0) saved[var] = best[var];
+            }
+            std::fill(best.begin(), best.end(), 0);
+            best_size = 0;
+            break;
+        case Phase::Walk:
+            walk(token);
+            break;
+        }
+        std::fill(target.begin(), target.end(), 0);
+        target_size = 0;
+    }
+
+    // reset the saved phases to the result of a local search walk
+    void phaser::walk(std::stop_token token) {
+        num_walks++;
+        cnf::assignment values(expr.get_max_var());
+        for (variable var(1); var < static_cast<variable>(saved.size()); var++) {
+            values.assign(saved[var] > 0 ? var : -var);
+        }
+        const std::uint64_t flips = std::min(max_walk_flips, walk_flips_per_clause * expr.get_num_clauses());
+        local_search::walk(expr, values, flips, rand, token);
+        for (variable var(1); var < static_cast<variable>(saved.size()); var++) {
+            saved[var] = values.is_true(var) ? 1 : -1;
+        }
+    }
+
+    // add the work done to a set of statistics
+    void phaser::report(std::map<std::string, std::string>& stats) const {
+        stats.insert({"REPHASES", std::to_string(num_rephases)});
+        stats.insert({"WALKS", std::to_string(num_walks)});
+    }
+
+}
@@ -0,0 +1,250 @@
+// propagator.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "propagator.hpp"
+#include <algorithm>
+
+namespace solver {
+
+    using std::abs;
+    using cnf::lit_index;
+
+    // problem constructor
+    propagator::propagator(const cnf::cnf_expr& expr):
+        watches(2 * (static_cast<std::size_t>(expr.get_max_var()) + 1)),
+        values(2 * (static_cast<std::size_t>(expr.get_max_var()) + 1), 0),
+        levels(expr.get_max_var() + 1, 0),
+        reasons(expr.get_max_var() + 1, cnf::no_clause),
+        queue_head(0),
+        conflict(cnf::no_clause),
+        propagations(0),
+        watch_visits(0)
+    {
+        for (const clause& cl : expr.get_clauses()) {
+            add_clause(expr.get_clause(cl));
+        }
+    }
+
+    // literals of a stored clause
+    literal* propagator::clause_literals(clause cl) {
+        return &arena[cl + header_size];
+    }
+
+    // add a clause, watching its first two literals
+    // clauses added during search must list their unassigned or most
+    // recently falsified literals first
+    clause propagator::add_clause(cnf::lit_span lits, int id) {
+        clause cl = arena.size();
+        arena.push_back(lits.size());
+        arena.push_back(id);
+        arena.insert(arena.end(), lits.begin(), lits.end());
+        if (lits.empty()) {
+            conflict = cl;
+        } else if (lits.size() == 1) {
+            // unit clauses are assigned rather than watched
+            if (value(lits[0]) < 0) {
+                conflict = cl;
+            } else if (value(lits[0]) == 0) {
+                enqueue(lits[0], cl);
+            }
+        } else {
+            watches[lit_index(lits[0])].push_back({cl, lits[1]});
+            watches[lit_index(lits[1])].push_back({cl, lits[0]});
+        }
+        return cl;
+    }
+
+    // mark a clause as removed
+    void propagator::remove_clause(clause cl) {
+        arena[cl + 1] = removed_id;
+    }
+
+    // drop the removed clauses and move the others together
+    // Each clause left has its new position written over its id in the
+    // old store, so reasons and the given clauses can be looked up before
+    // the old store is dropped. The watch lists are built again, watching
+    // the first two literals of each clause as before.
+    void propagator::collect(std::vector<clause>& kept) {
+        std::vector<literal> compacted;
+        compacted.reserve(arena.size());
+        for (std::size_t cl(0); cl < arena.size(); cl += header_size + arena[cl]) {
+            if (arena[cl + 1] == removed_id) continue;
+            const clause moved = compacted.size();
+            compacted.insert(compacted.end(), arena.begin() + cl, arena.begin() + cl + header_size + arena[cl]);
+            arena[cl + 1] = moved;
+        }
+        for (const literal& lit : trail) {
+            if (reasons[abs(lit)] != cnf::no_clause) {
+                reasons[abs(lit)] = arena[reasons[abs(lit)] + 1];
+            }
+        }
+        if (conflict != cnf::no_clause) {
+            conflict = arena[conflict + 1];
+        }
+        for (clause& cl : kept) {
+            cl = arena[cl + 1];
+        }
+        arena.swap(compacted);
+        for (std::vector<watcher>& watch_list : watches) {
+            watch_list.clear();
+        }
+        for (std::size_t cl(0); cl < arena.size(); cl += header_size + arena[cl]) {
+            if (arena[cl] < 2) continue;
+            const literal* lits = &arena[cl + header_size];
+            watches[lit_index(lits[0])].push_back({static_cast<clause>(cl), lits[1]});
+            watches[lit_index(lits[1])].push_back({static_cast<clause>(cl), lits[0]});
+        }
+    }
+
+    // begin a new decision level
+    void propagator::new_level() {
+        trail_lim.push_back(trail.size());
+    }
+
+    // assign a literal with the clause that implied it
+    bool propagator::enqueue(literal lit, clause reason) {
+        if (value(lit) != 0) {
+            return value(lit) > 0;
+        }
+        values[lit_index(lit)] = 1;
+        values[lit_index(-lit)] = -1;
+        levels[abs(lit)] = level();
+        reasons[abs(lit)] = reason;
+        trail.push_back(lit);
+        return true;
+    }
+
+    // propagate queued assignments; returns a conflicting clause
+    clause propagator::propagate() {
+        if (conflict != cnf::no_clause) {
+            return conflict;
+        }
+        while (queue_head < trail.size()) {
+            const literal false_lit = -trail[queue_head++];
+            std::vector<watcher>& watch_list = watches[lit_index(false_lit)];
+            propagations++;
+            auto keep = watch_list.begin();
+            auto iter = watch_list.begin();
+            while (iter != watch_list.end()) {
+                watch_visits++;
+                // the clause is satisfied by its blocker
+                if (value(iter->blocker) > 0) {
+                    *keep++ = *iter++;
+                    continue;
+                }
+                // make sure the false literal is the second watch
+                const clause cl = iter->cl;
+                literal* lits = clause_literals(cl);
+                const std::size_t size = arena[cl];
+                if (lits[0] == false_lit) {
+                    std::swap(lits[0], lits[1]);
+                }
+                iter++;
+                // the clause is satisfied by the other watch
+                const watcher updated{cl, lits[0]};
+                if (value(lits[0]) > 0) {
+                    *keep++ = updated;
+                    continue;
+                }
+                // look for a new literal to watch
+                bool moved(false);
+                for (std::size_t i(2); i < size; i++) {
+                    if (value(lits[i]) >= 0) {
+                        std::swap(lits[1], lits[i]);
+                        watches[lit_index(lits[1])].push_back(updated);
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved) continue;
+                // the clause is unit or conflicting
+                *keep++ = updated;
+                if (value(lits[0]) < 0) {
+                    // keep the remaining watchers and stop
+                    keep = std::copy(iter, watch_list.end(), keep);
+                    watch_list.erase(keep, watch_list.end());
+                    queue_head = trail.size();
+                    return cl;
+                }
+                enqueue(lits[0], cl);
+            }
+            watch_list.erase(keep, watch_list.end());
+        }
+        return cnf::no_clause;
+    }
+
+    // undo every assignment above the given decision level
+    void propagator::backtrack(int target_level) {
+        if (target_level >= level()) return;
+        const std::size_t target_size = trail_lim[target_level];
+        while (trail.size() > target_size) {
+            const variable var = abs(trail.back());
+            values[lit_index(var)] = 0;
+            values[lit_index(-var)] = 0;
+            reasons[var] = cnf::no_clause;
+            trail.pop_back();
+        }
+        trail_lim.resize(target_level);
+        queue_head = std::min(queue_head, trail.size());
+    }
+
+    // give the value of a literal: 1 if true, -1 if false, 0 if unassigned
+    int propagator::value(literal lit) const {
+        return values[lit_index(lit)];
+    }
+
+    // give the current decision level
+    int propagator::level() const {
+        return trail_lim.size();
+    }
+
+    // give the decision level at which a variable was assigned
+    int propagator::level_of(variable var) const {
+        return levels[var];
+    }
+
+    // give the clause that implied a variable's value
+    clause propagator::reason_of(variable var) const {
+        return reasons[var];
+    }
+
+    // check whether a clause implied a current assignment
+    // the implied literal of a reason is always its first
+    bool propagator::is_reason(clause cl) const {
+        if (arena[cl] == 0) return false;
+        const variable var = abs(arena[cl + header_size]);
+        return value(var) != 0 && reasons[var] == cl;
+    }
+
+    // give the id of a stored clause
+    int propagator::id_of(clause cl) const {
+        return arena[cl + 1];
+    }
+
+    // change the id of a stored clause
+    void propagator::set_id(clause cl, int id) {
+        arena[cl + 1] = id;
+    }
+
+    // return the literals of a stored clause
+    cnf::lit_span propagator::get_clause(clause cl) const {
+        return cnf::lit_span(&arena[cl + header_size], arena[cl]);
+    }
+
+    // give the assignment trail
+    const std::vector<literal>& propagator::get_trail() const {
+        return trail;
+    }
+
+    // give the number of assignments propagated so far
+    std::uint64_t propagator::num_propagations() const {
+        return propagations;
+    }
+
+    // give the number of watch list entries visited so far
+    std::uint64_t propagator::num_watch_visits() const {
+        return watch_visits;
+    }
+
+}
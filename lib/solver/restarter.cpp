@@ -0,0 +1,124 @@
+// restarter.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "restarter.hpp"
+
+namespace solver {
+
+    using namespace std::string_literals;
+
+    // the conflicts of one step of the Luby and geometric policies
+    static constexpr std::uint64_t restart_unit = 100;
+    // the growth of the geometric interval after each restart
+    static constexpr double geometric_growth = 1.5;
+    // Glucose: the weights of the averages, the factor by which the fast
+    // LBD average must exceed the slow, and the least conflicts between
+    // restarts
+    static constexpr double fast_weight = 1.0 / 32;
+    static constexpr double slow_weight = 1.0 / 4096;
+    static constexpr double trail_weight = 1.0 / 4096;
+    static constexpr double restart_margin = 1.25;
+    static constexpr std::uint64_t min_conflicts = 50;
+    // Glucose: the factor by which the trail must exceed its average to
+    // block a restart, and the conflicts before blocking starts
+    static constexpr double blocking_margin = 1.4;
+    static constexpr std::uint64_t blocking_start = 10000;
+
+    // give the i-th term of the Luby sequence, counting from zero
+    static std::uint64_t luby(std::uint64_t i) {
+        // find the complete subsequence holding the term
+        std::uint64_t size(1);
+        std::uint64_t term(1);
+        while (size < i + 1) {
+            size = 2 * size + 1;
+            term *= 2;
+        }
+        // descend into the subsequence until the term ends one
+        while (size - 1 != i) {
+            size /= 2;
+            term /= 2;
+            i %= size;
+        }
+        return term;
+    }
+
+    // policy constructor
+    restarter::restarter(Restarts policy):
+        policy(policy),
+        conflicts(0),
+        limit(restart_unit),
+        luby_index(0),
+        fast_lbd{0, fast_weight, 0},
+        slow_lbd{0, slow_weight, 0},
+        trail{0, trail_weight, 0},
+        total_conflicts(0),
+        num_restarts(0),
+        num_blocked(0)
+    {}
+
+    // add a value to the average
+    void restarter::average::update(double x) {
+        count++;
+        const double w = count * weight < 1 ? 1.0 / count : weight;
+        value += w * (x - value);
+    }
+
+    // note a conflict
+    void restarter::conflict(int lbd, std::size_t trail_size) {
+        conflicts++;
+        total_conflicts++;
+        if (policy != Restarts::Glucose) return;
+        fast_lbd.update(lbd);
+        slow_lbd.update(lbd);
+        // a long trail suggests a solution is near, so wait
+        if (
+            total_conflicts > blocking_start &&
+            conflicts >= min_conflicts &&
+            trail_size > blocking_margin * trail.value
+        ) {
+            conflicts = 0;
+            num_blocked++;
+        }
+        trail.update(trail_size);
+    }
+
+    // check whether a restart is due
+    bool restarter::due() const {
+        switch (policy) {
+        case Restarts::Glucose:
+            return conflicts >= min_conflicts && fast_lbd.value > restart_margin * slow_lbd.value;
+        case Restarts::Luby:
+        case Restarts::Geometric:
+            return conflicts >= limit;
+        default:
+            return false;
+        }
+    }
+
+    // note that the solver restarted
+    void restarter::restart() {
+        num_restarts++;
+        conflicts = 0;
+        if (policy == Restarts::Luby) {
+            limit = restart_unit * luby(++luby_index);
+        } else if (policy == Restarts::Geometric) {
+            limit = static_cast<std::uint64_t>(limit * geometric_growth);
+        }
+    }
+
+    // add the work done to a set of statistics
+    void restarter::report(std::map<std::string, std::string>& stats) const {
+        stats.insert({"RESTART_POLICY",
+            policy == Restarts::Glucose   ? "glucose"s   :
+            policy == Restarts::Luby      ? "luby"s      :
+            policy == Restarts::Geometric ? "geometric"s :
+                                            "never"s
+        });
+        stats.insert({"RESTARTS", std::to_string(num_restarts)});
+        if (policy == Restarts::Glucose) {
+            stats.insert({"BLOCKED_RESTARTS", std::to_string(num_blocked)});
+        }
+    }
+
+}
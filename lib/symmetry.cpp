@@ -0,0 +1,485 @@
+// symmetry.cpp
+// Logan Moonie
+// Oct 17, 2026
+
+#include "symmetry.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace symmetry {
+
+    // will need abs frequently
+    using std::abs;
+    using clock = std::chrono::steady_clock;
+
+    // the nodes visited below each vertex tried on the way back up the
+    // first path, before it is given up
+    constexpr std::size_t max_descent_nodes = 64;
+
+    // a lex-leader predicate compares at most this many variables; its
+    // clauses double with each one, and a short predicate already rules
+    // out most symmetric solutions
+    constexpr std::size_t max_predicate_length = 6;
+
+    // the clock is read once every this many limit checks
+    constexpr std::size_t check_interval = 64;
+
+    // mix a value into a trace
+    inline std::uint64_t mix(std::uint64_t trace, std::uint64_t value) {
+        return (trace ^ value) * 0x100000001b3ull + (trace >> 29);
+    }
+
+    // time limit constructor
+    breaker::breaker(clock::duration time_limit):
+        num_literals(0),
+        num_cells(0),
+        limit(time_limit),
+        checks(0),
+        timed_out(false),
+        ran(false),
+        num_clauses(0),
+        seconds(0)
+    {}
+
+    // find the symmetries of an expression and add clauses breaking them
+    void breaker::operator()(cnf::cnf_expr& expr) {
+        const clock::time_point start = clock::now();
+        deadline = start + limit;
+        ran = true;
+        build(expr);
+        if (!lab.empty()) {
+            search();
+        }
+        add_predicates(expr);
+        // only the generators are needed from here on
+        for (auto* list : {&offsets, &edges, &lab, &inv, &cell, &cell_end, &queue, &counts,
+                &touched, &path_vertex, &path_cell, &first_leaf, &perm, &orbits}) {
+            std::vector<std::uint32_t>().swap(*list);
+        }
+        seconds = std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    // add the work done to a set of statistics
+    void breaker::report(std::map<std::string, std::string>& stats) const {
+        if (!ran) {
+            return;
+        }
+        stats.insert({"SYMMETRY_GENERATORS", std::to_string(generators.size())});
+        stats.insert({"SYMMETRY_CLAUSES", std::to_string(num_clauses)});
+        stats.insert({"SYMMETRY_TIME_SECONDS", std::to_string(seconds)});
+    }
+
+    // give the number of generators found
+    std::size_t breaker::num_generators() const {
+        return generators.size();
+    }
+
+    // give the number of clauses added
+    std::size_t breaker::num_added_clauses() const {
+        return num_clauses;
+    }
+
+    // build the graph of an expression
+    // only variables in some clause get vertices; the graph is not built
+    // if it would not fit in 32-bit vertex numbers
+    void breaker::build(const cnf::cnf_expr& expr) {
+        std::vector<std::uint32_t> index(static_cast<std::size_t>(expr.get_max_var()) + 1, 0);
+        std::uint64_t num_edges(0);
+        for (const cnf::clause& cl : expr.get_clauses()) {
+            for (const literal& lit : expr.get_clause(cl)) {
+                index[abs(lit)] = 1;
+            }
+            num_edges += 2 * expr.get_clause(cl).size();
+        }
+        for (variable var(1); static_cast<std::size_t>(var) < index.size(); var++) {
+            if (index[var] != 0) {
+                index[var] = vars.size();
+                vars.push_back(var);
+            }
+        }
+        num_edges += 2 * vars.size();
+        const std::uint64_t num_vertices = 2 * vars.size() + expr.get_clauses().size();
+        if (vars.empty() || num_edges >= std::numeric_limits<std::uint32_t>::max()) {
+            return;
+        }
+        num_literals = 2 * vars.size();
+        auto vertex = [&](literal lit) {
+            return 2 * index[abs(lit)] + (lit < 0);
+        };
+
+        // count the neighbours of each vertex, then place them
+        offsets.assign(num_vertices + 1, 0);
+        for (std::uint32_t k(0); k < num_literals; k++) {
+            offsets[k + 1] = 1;
+        }
+        std::uint32_t clause_vertex(num_literals);
+        for (const cnf::clause& cl : expr.get_clauses()) {
+            for (const literal& lit : expr.get_clause(cl)) {
+                offsets[vertex(lit) + 1]++;
+            }
+            offsets[clause_vertex + 1] = expr.get_clause(cl).size();
+            clause_vertex++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        edges.resize(num_edges);
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::uint32_t k(0); k < num_literals; k++) {
+            edges[fill[k]++] = k ^ 1;
+        }
+        clause_vertex = num_literals;
+        for (const cnf::clause& cl : expr.get_clauses()) {
+            for (const literal& lit : expr.get_clause(cl)) {
+                edges[fill[vertex(lit)]++] = clause_vertex;
+                edges[fill[clause_vertex]++] = vertex(lit);
+            }
+            clause_vertex++;
+        }
+
+        // literals and clauses start in a cell of their own colour
+        lab.resize(num_vertices);
+        std::iota(lab.begin(), lab.end(), 0);
+        inv = lab;
+        cell.assign(num_vertices, 0);
+        cell_end.assign(num_vertices, 0);
+        queued.assign(num_vertices, false);
+        counts.assign(num_vertices, 0);
+        cell_end[0] = num_literals;
+        queue.push_back(0);
+        queued[0] = true;
+        num_cells = 1;
+        if (num_vertices > num_literals) {
+            for (std::uint32_t v(num_literals); v < num_vertices; v++) {
+                cell[v] = num_literals;
+            }
+            cell_end[num_literals] = num_vertices;
+            queue.push_back(num_literals);
+            queued[num_literals] = true;
+            num_cells++;
+        }
+    }
+
+    // check whether the time limit was reached
+    bool breaker::out_of_time() {
+        if (!timed_out && ++checks % check_interval == 0 && clock::now() >= deadline) {
+            timed_out = true;
+        }
+        return timed_out;
+    }
+
+    // split the cells until the partition is equitable
+    // Each queued cell in turn counts the neighbours every vertex has in
+    // it, and each cell is split by those counts. The order of the new
+    // cells, and so the trace, depends only on the counts and positions,
+    // so two partitions related by an automorphism refine alike.
+    std::uint64_t breaker::refine() {
+        std::uint64_t trace(num_cells);
+        std::vector<std::uint32_t> bounds;
+        std::size_t head(0);
+        for (; head < queue.size() && !out_of_time(); head++) {
+            const std::uint32_t splitter = queue[head];
+            queued[splitter] = false;
+            trace = mix(trace, splitter);
+            for (std::uint32_t p(splitter); p < cell_end[splitter]; p++) {
+                const std::uint32_t v = lab[p];
+                for (std::uint32_t i(offsets[v]); i < offsets[v + 1]; i++) {
+                    if (counts[edges[i]]++ == 0) {
+                        touched.push_back(edges[i]);
+                    }
+                }
+            }
+            // group the touched vertices by cell, then by count
+            std::sort(touched.begin(), touched.end(), [&](std::uint32_t a, std::uint32_t b) {
+                return cell[a] != cell[b] ? cell[a] < cell[b] : counts[a] < counts[b];
+            });
+            for (std::size_t first(0), last(0); first < touched.size(); first = last) {
+                const std::uint32_t start = cell[touched[first]];
+                const std::uint32_t end = cell_end[start];
+                while (last < touched.size() && cell[touched[last]] == start) {
+                    last++;
+                }
+                const std::uint32_t num_touched = last - first;
+                if (num_touched == end - start && counts[touched[first]] == counts[touched[last - 1]]) {
+                    continue;
+                }
+                // untouched vertices have no neighbours in the splitter,
+                // so they come first, followed by the touched in order
+                bounds.assign(1, start);
+                for (std::size_t k(first); k < last; k++) {
+                    const std::uint32_t target = end - num_touched + (k - first);
+                    const std::uint32_t moved = lab[target];
+                    lab[inv[touched[k]]] = moved;
+                    inv[moved] = inv[touched[k]];
+                    lab[target] = touched[k];
+                    inv[touched[k]] = target;
+                    if (target != start && (k == first || counts[touched[k]] != counts[touched[k - 1]])) {
+                        bounds.push_back(target);
+                    }
+                }
+                bounds.push_back(end);
+                trace = mix(trace, start);
+                const bool was_queued = queued[start];
+                std::size_t largest(0);
+                for (std::size_t g(0); g + 1 < bounds.size(); g++) {
+                    trace = mix(mix(trace, counts[lab[bounds[g]]]), bounds[g + 1] - bounds[g]);
+                    if (bounds[g + 1] - bounds[g] > bounds[largest + 1] - bounds[largest]) {
+                        largest = g;
+                    }
+                    if (g > 0) {
+                        cell_end[bounds[g - 1]] = bounds[g];
+                        cell_end[bounds[g]] = bounds[g + 1];
+                        for (std::uint32_t p(bounds[g]); p < bounds[g + 1]; p++) {
+                            cell[lab[p]] = bounds[g];
+                        }
+                        splits.push_back({bounds[g], bounds[g - 1]});
+                        num_cells++;
+                    }
+                }
+                // a cell already waiting covers its first part; otherwise
+                // every part but the largest is enough
+                for (std::size_t g(0); g + 1 < bounds.size(); g++) {
+                    if (!queued[bounds[g]] && (was_queued || g != largest)) {
+                        queue.push_back(bounds[g]);
+                        queued[bounds[g]] = true;
+                    }
+                }
+            }
+            for (const std::uint32_t& v : touched) {
+                counts[v] = 0;
+            }
+            touched.clear();
+        }
+        for (; head < queue.size(); head++) {
+            queued[queue[head]] = false;
+        }
+        queue.clear();
+        return trace;
+    }
+
+    // split a vertex from its cell, which must hold others
+    void breaker::individualize(std::uint32_t v) {
+        const std::uint32_t start = cell[v];
+        const std::uint32_t end = cell_end[start];
+        const std::uint32_t moved = lab[start];
+        lab[inv[v]] = moved;
+        inv[moved] = inv[v];
+        lab[start] = v;
+        inv[v] = start;
+        cell_end[start] = start + 1;
+        cell_end[start + 1] = end;
+        for (std::uint32_t p(start + 1); p < end; p++) {
+            cell[lab[p]] = start + 1;
+        }
+        splits.push_back({start + 1, start});
+        num_cells++;
+        queue.push_back(start);
+        queued[start] = true;
+    }
+
+    // undo every split made after the given number of splits
+    // cells are merged back in reverse; the order within them is not kept
+    void breaker::undo(std::size_t mark) {
+        while (splits.size() > mark) {
+            const auto [start, previous] = splits.back();
+            splits.pop_back();
+            const std::uint32_t end = cell_end[start];
+            cell_end[previous] = end;
+            for (std::uint32_t p(start); p < end; p++) {
+                cell[lab[p]] = previous;
+            }
+            num_cells--;
+        }
+    }
+
+    // give the first cell holding more than one vertex, from a position
+    // before which every cell holds one
+    std::uint32_t breaker::target_cell(std::uint32_t p) const {
+        while (p < lab.size() && cell_end[p] - p == 1) {
+            p = cell_end[p];
+        }
+        return p;
+    }
+
+    // Given a level of the first path, and a partition whose refinement
+    // has matched the first path so far, descend searches for a discrete
+    // partition below it, trying the vertex of the first path first. It
+    // stops once the budget of nodes is spent, and returns whether an
+    // automorphism was found, leaving it in perm.
+    bool breaker::descend(std::size_t level, std::size_t& budget) {
+        if (num_cells == lab.size()) {
+            for (std::uint32_t p(0); p < lab.size(); p++) {
+                perm[first_leaf[p]] = lab[p];
+            }
+            return is_automorphism();
+        }
+        if (level >= path_cell.size()) {
+            return false;
+        }
+        // the refinements matched, so the cell split on the first path
+        // must be a cell here too
+        const std::uint32_t start = path_cell[level];
+        if (cell[lab[start]] != start || cell_end[start] - start < 2) {
+            return false;
+        }
+        const std::size_t mark = splits.size();
+        std::vector<std::uint32_t> candidates(lab.begin() + start, lab.begin() + cell_end[start]);
+        const auto same = std::ranges::find(candidates, path_vertex[level]);
+        if (same != candidates.end()) {
+            std::iter_swap(candidates.begin(), same);
+        }
+        for (const std::uint32_t& u : candidates) {
+            if (budget == 0 || out_of_time()) {
+                return false;
+            }
+            budget--;
+            individualize(u);
+            const bool found = refine() == path_trace[level] && descend(level + 1, budget);
+            undo(mark);
+            if (found) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // check whether the permutation is an automorphism
+    // the neighbours of each vertex must map onto the neighbours of its image
+    bool breaker::is_automorphism() const {
+        std::vector<bool> marks(lab.size(), false);
+        for (std::uint32_t u(0); u < lab.size(); u++) {
+            const std::uint32_t w = perm[u];
+            if ((u < num_literals) != (w < num_literals) || offsets[u + 1] - offsets[u] != offsets[w + 1] - offsets[w]) {
+                return false;
+            }
+            for (std::uint32_t i(offsets[u]); i < offsets[u + 1]; i++) {
+                marks[perm[edges[i]]] = true;
+            }
+            bool kept(true);
+            for (std::uint32_t i(offsets[w]); i < offsets[w + 1]; i++) {
+                kept = kept && marks[edges[i]];
+            }
+            for (std::uint32_t i(offsets[u]); i < offsets[u + 1]; i++) {
+                marks[perm[edges[i]]] = false;
+            }
+            if (!kept) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // keep the permutation as a generator, and join the orbits it links
+    void breaker::record() {
+        std::vector<std::pair<variable, literal>> generator;
+        for (std::uint32_t k(0); k < vars.size(); k++) {
+            const std::uint32_t image = perm[2 * k];
+            if (image != 2 * k) {
+                generator.push_back({vars[k], image & 1 ? -vars[image / 2] : vars[image / 2]});
+            }
+        }
+        for (std::uint32_t u(0); u < perm.size(); u++) {
+            orbits[orbit(u)] = orbit(perm[u]);
+        }
+        // a permutation of duplicate clauses alone moves no variables
+        if (!generator.empty()) {
+            generators.push_back(std::move(generator));
+        }
+    }
+
+    // find the orbit of a vertex
+    std::uint32_t breaker::orbit(std::uint32_t v) {
+        while (orbits[v] != v) {
+            orbits[v] = orbits[orbits[v]];
+            v = orbits[v];
+        }
+        return v;
+    }
+
+    // search for generators
+    // The first path is followed down to a discrete partition. Then, from
+    // the deepest level up, every other vertex of the cell split at that
+    // level is tried in place of the first path's vertex. Generators found
+    // below a level fix the vertices chosen above it, so vertices already
+    // in the orbit of the first path's vertex need no search.
+    void breaker::search() {
+        refine();
+        while (num_cells < lab.size() && !timed_out) {
+            const std::uint32_t target = target_cell(path_cell.empty() ? 0 : path_cell.back());
+            path_cell.push_back(target);
+            path_vertex.push_back(lab[target]);
+            path_mark.push_back(splits.size());
+            individualize(lab[target]);
+            path_trace.push_back(refine());
+        }
+        if (timed_out) {
+            return;
+        }
+        first_leaf = lab;
+        perm.resize(lab.size());
+        orbits.resize(lab.size());
+        std::iota(orbits.begin(), orbits.end(), 0);
+        for (std::size_t level(path_cell.size()); level-- > 0;) {
+            undo(path_mark[level]);
+            const std::uint32_t start = path_cell[level];
+            const std::vector<std::uint32_t> candidates(lab.begin() + start, lab.begin() + cell_end[start]);
+            for (const std::uint32_t& w : candidates) {
+                if (out_of_time()) {
+                    return;
+                }
+                if (orbit(w) == orbit(path_vertex[level])) {
+                    continue;
+                }
+                std::size_t budget(max_descent_nodes);
+                individualize(w);
+                if (refine() == path_trace[level] && descend(level + 1, budget)) {
+                    record();
+                }
+                undo(path_mark[level]);
+            }
+        }
+    }
+
+    // add a lex-leader predicate for each generator
+    // Each variable x, in order, may be true only if its image y is, unless
+    // the solutions already differ on an earlier variable. Given the
+    // earlier comparisons, they differ on an earlier variable w with
+    // image z exactly when w is false and z is true, so the clauses for x
+    // hold -w or z for each earlier w, in every combination. The chain
+    // ends once x is mapped to its own negation, since x must then be
+    // false and the two cannot be equal.
+    void breaker::add_predicates(cnf::cnf_expr& expr) {
+        std::vector<std::vector<literal>> prefixes;
+        std::vector<std::vector<literal>> longer;
+        std::vector<literal> lits;
+        for (const auto& generator : generators) {
+            prefixes.assign(1, {});
+            const std::size_t length = std::min(generator.size(), max_predicate_length);
+            for (std::size_t i(0); i < length; i++) {
+                const auto [var, image] = generator[i];
+                for (const std::vector<literal>& prefix : prefixes) {
+                    lits = prefix;
+                    lits.push_back(-var);
+                    lits.push_back(image);
+                    const bool tautology = std::ranges::any_of(lits, [&](literal lit) {
+                        return std::ranges::find(lits, -lit) != lits.end();
+                    });
+                    if (!tautology) {
+                        expr.add_clause(lits);
+                        num_clauses++;
+                    }
+                }
+                if (image == -var) {
+                    break;
+                }
+                longer.clear();
+                for (const std::vector<literal>& prefix : prefixes) {
+                    for (const literal& lit : {-var, image}) {
+                        longer.push_back(prefix);
+                        longer.back().push_back(lit);
+                    }
+                }
+                prefixes.swap(longer);
+            }
+        }
+    }
+}
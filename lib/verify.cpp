@@ -29,12 +29,12 @@ namespace verify {
         if (!sol.is_valid()) {
             throw std::invalid_argument(err::invalid_solution);
         }
-        if (sol.get_num_clauses() != cnf.get_num_clauses() &&
+        if (sol.get_num_clauses() != cnf.get_num_input_clauses() &&
             sol.get_type() == sol::ProblemType::CNF
         ) {
             throw std::invalid_argument(err::solution_clauses);
         }
-        if (sol.get_max_var() != cnf.get_max_var()) {
+        if (sol.get_max_var() != cnf.get_max_input_var()) {
             throw std::invalid_argument(err::solution_vars);
         }
         if (static_cast<bool>(sol.get_type()) !=
@@ -43,7 +43,11 @@ namespace verify {
             throw std::invalid_argument(err::type_mismatch);
         }
         try {
-            return cnf.eval(sol.map());
+            // variables introduced by the encoding take the values
+            // their definitions give them
+            cnf::assignment assigns = sol.assignment();
+            cnf.extend(assigns);
+            return cnf.eval(assigns);
         } catch (...) {
             throw std::invalid_argument(err::wrong_variables);
         }
@@ -85,8 +89,8 @@ namespace verify {
                 pif.quiet = true;
             }
             if (pif.var_map.count("problem") == 1) {
-                pif.pstr = std::fstream(pif.var_map["problem"].as<std::string>());
-                if (!pif.pstr) {
+                pif.problem_path = pif.var_map["problem"].as<std::string>();
+                if (!std::ifstream(pif.problem_path)) {
                     throw std::invalid_argument(err::not_open_file);
                 }
             } else if (pif.var_map.count("problem") > 1) {